@@ -0,0 +1,767 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @brief copa throughput benchmark
+ *
+ * @details Run the calculator, language and json-like grammars over generated inputs of increasing size (1KB up to
+ * --max-size) through a @c fil::buffer_reader and a @c fil::file_reader, and compare them against a hand-written
+ * recursive descent parser of the same language.
+ *
+ * The report is a JSON document containing for each case the throughput (MB/s), the number of allocations per byte
+ * parsed and the peak resident set size reached during the case (the peak of the process, VmHWM, is reset before each
+ * case through /proc/self/clear_refs: if it can't be, the peak reported is the one of the whole process so far).
+ *
+ * Usage : copa_bench [--min-size 1K] [--max-size 64M] [--budget 67108864] [--grammar json] [--output report.json]
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fil/cli/command_line_interface.hh"
+#include "fil/copa/copa.hh"
+#include "fil/copa/member.hh"
+#include "fil/copa/sink.hh"
+#include "fil/copa/wrapper_utils.hh"
+#include "fil/datastructure/rng.hh"
+#include "fil/file/file_reader.hh"
+#include "fil/file/temporary.hh"
+#include "fil/meta/buffer_reader.hh"
+
+namespace {
+std::atomic<std::size_t> allocation_count {0};
+}
+
+// allocation counting : every operator new of the process goes through those replacements
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+/**
+ * @brief base of the hand-written baseline parsers, provide the scanning primitives on a string_view
+ */
+class baseline_scanner {
+  public:
+    explicit baseline_scanner(std::string_view content)
+        : content_(content) {}
+
+  protected:
+    void skip_() {
+        while (cursor_ < content_.size() && std::isspace(static_cast<unsigned char>(content_[cursor_])))
+            ++cursor_;
+    }
+
+    [[nodiscard]] bool at_end_() {
+        skip_();
+        return cursor_ >= content_.size();
+    }
+
+    [[nodiscard]] bool consume_(std::string_view token) {
+        skip_();
+        if (content_.substr(cursor_).starts_with(token)) {
+            cursor_ += token.size();
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] std::optional<long long> number_() {
+        skip_();
+        const auto start = cursor_;
+        long long value  = 0;
+        while (cursor_ < content_.size() && std::isdigit(static_cast<unsigned char>(content_[cursor_])))
+            value = value * 10 + (content_[cursor_++] - '0');
+        return cursor_ == start ? std::nullopt : std::optional {value};
+    }
+
+    [[nodiscard]] std::string_view identifier_() {
+        skip_();
+        const auto start = cursor_;
+        while (cursor_ < content_.size() && (std::isalnum(static_cast<unsigned char>(content_[cursor_])) || content_[cursor_] == '_'))
+            ++cursor_;
+        return content_.substr(start, cursor_ - start);
+    }
+
+    std::string_view content_;
+    std::size_t cursor_ = 0;
+};
+
+//
+// calculator : arithmetic expressions separated by semicolons
+//
+namespace calculator {
+
+enum class op {
+    none,
+    plus,
+    minus,
+    multiply,
+    divide
+};
+using ast_node = fil::copa::ast_node<[](const std::string& token) -> op {
+    if (token == "+")
+        return op::plus;
+    if (token == "-")
+        return op::minus;
+    if (token == "*")
+        return op::multiply;
+    if (token == "/")
+        return op::divide;
+    return op::none;
+}>;
+
+struct level_2_grammar {
+    using ast_object = ast_node;
+
+    static constexpr auto rules() {
+        return fil::copa::match_string<fil::fixed_string {"*"}, ast_node::operand> {} //
+             | fil::copa::match_string<fil::fixed_string {"/"}, ast_node::operand> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_node> {2}; }
+};
+
+struct level_1_grammar {
+    using ast_object = ast_node;
+
+    static constexpr auto rules() {
+        return fil::copa::match_string<fil::fixed_string {"+"}, ast_node::operand> {} //
+             | fil::copa::match_string<fil::fixed_string {"-"}, ast_node::operand> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_node> {1}; }
+};
+
+struct base_grammar {
+    using ast_object = ast_node;
+
+    static constexpr fil::copa::rule auto rules();
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_node> {0}; }
+};
+
+struct expression_grammar {
+    using ast_object = ast_node;
+
+    static constexpr auto rules() {
+        return fil::copa::list_rule<fil::copa::or_rule< //
+            fil::copa::match_parser<base_grammar>,      //
+            fil::copa::match_parser<level_1_grammar>,   //
+            fil::copa::match_parser<level_2_grammar>    //
+            >> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_node> {0}; }
+};
+
+constexpr fil::copa::rule auto base_grammar::rules() {
+    return fil::copa::match_number<ast_node::leaf> {}
+         | fil::copa::parenthesised(fil::copa::match_production<expression_grammar, ast_node::leaf> {});
+}
+
+struct program_grammar {
+    struct ast_object {
+        std::vector<ast_node> statements;
+    };
+
+    static constexpr auto rules() {
+        return fil::copa::list(fil::copa::match_production<expression_grammar, fil::copa::member<&ast_object::statements>> {} //
+                               + fil::copa::semicol);
+    }
+    static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+};
+
+std::string generate(fil::rng& rng, std::size_t target_size) {
+    static constexpr std::array operators {" + ", " - ", " * ", " / "};
+
+    std::string content;
+    content.reserve(target_size + 128);
+    while (content.size() < target_size) {
+        const auto operands = rng.generate_in_range(2, 8);
+        for (int i = 0; i < operands; ++i) {
+            if (i != 0)
+                content += operators[rng.generate_in_range(0, 3)];
+            if (rng.generate_in_range(0, 4) == 0) {
+                std::format_to(std::back_inserter(content), "({} + {})", rng.generate_in_range(0, 999), rng.generate_in_range(0, 999));
+            } else {
+                std::format_to(std::back_inserter(content), "{}", rng.generate_in_range(0, 9999));
+            }
+        }
+        content += ";\n";
+    }
+    return content;
+}
+
+/**
+ * @brief evaluating recursive descent parser, one result per statement
+ */
+class baseline : baseline_scanner {
+  public:
+    using baseline_scanner::baseline_scanner;
+
+    std::optional<std::vector<long long>> parse() {
+        std::vector<long long> results;
+        while (!at_end_()) {
+            const auto value = expression_();
+            if (!value.has_value() || !consume_(";"))
+                return std::nullopt;
+            results.push_back(*value);
+        }
+        return results;
+    }
+
+  private:
+    std::optional<long long> expression_() {
+        auto lhs = term_();
+        while (lhs.has_value()) {
+            const bool plus = consume_("+");
+            if (!plus && !consume_("-"))
+                break;
+            const auto rhs = term_();
+            if (!rhs.has_value())
+                return std::nullopt;
+            lhs = plus ? *lhs + *rhs : *lhs - *rhs;
+        }
+        return lhs;
+    }
+
+    std::optional<long long> term_() {
+        auto lhs = factor_();
+        while (lhs.has_value()) {
+            const bool multiply = consume_("*");
+            if (!multiply && !consume_("/"))
+                break;
+            const auto rhs = factor_();
+            if (!rhs.has_value())
+                return std::nullopt;
+            lhs = multiply ? *lhs * *rhs : (*rhs == 0 ? 0 : *lhs / *rhs);
+        }
+        return lhs;
+    }
+
+    std::optional<long long> factor_() {
+        if (consume_("(")) {
+            const auto value = expression_();
+            return consume_(")") ? value : std::nullopt;
+        }
+        return number_();
+    }
+};
+
+} // namespace calculator
+
+//
+// language : boolean condition on variables separated by semicolons
+//
+namespace language {
+
+enum class op_comparator {
+    none,
+    greater,
+    greater_equal,
+    less,
+    less_equal,
+    equal,
+    different,
+};
+enum class op_link {
+    none,
+    or_,
+    and_,
+};
+
+struct variable {
+    std::string variable_name;
+    std::optional<std::string> access = std::nullopt;
+};
+
+struct variable_grammar {
+    using ast_object = variable;
+
+    static constexpr auto rules() {
+        return (fil::copa::match_identifier<fil::copa::member<&ast_object::variable_name>> {} //
+                + fil::copa::point                                                            //
+                + fil::copa::match_identifier<fil::copa::member<&ast_object::access>> {})
+             | fil::copa::match_identifier<fil::copa::member<&ast_object::variable_name>> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+};
+
+using ast_node = fil::copa::ast_node< //
+    [](const std::string& token) -> std::variant<op_link, op_comparator> {
+        if (token == "&&")
+            return op_link::and_;
+        if (token == "||")
+            return op_link::or_;
+        if (token == ">")
+            return op_comparator::greater;
+        if (token == ">=")
+            return op_comparator::greater_equal;
+        if (token == "<=")
+            return op_comparator::less_equal;
+        if (token == "<")
+            return op_comparator::less;
+        if (token == "!=")
+            return op_comparator::different;
+        if (token == "==")
+            return op_comparator::equal;
+        return op_link::none;
+    },
+    variable>;
+
+struct link_grammar {
+    using ast_object = ast_node;
+
+    static constexpr auto rules() {
+        return fil::copa::match_string<fil::fixed_string {"&&"}, ast_object::operand> {} //
+             | fil::copa::match_string<fil::fixed_string {"||"}, ast_object::operand> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_object> {1}; }
+};
+
+struct compare_grammar {
+    using ast_object = ast_node;
+
+    static constexpr auto rules() {
+        return fil::copa::match_string<fil::fixed_string {">="}, ast_object::operand> {} //
+             | fil::copa::match_string<fil::fixed_string {">"}, ast_object::operand> {}
+             | fil::copa::match_string<fil::fixed_string {"<="}, ast_object::operand> {}
+             | fil::copa::match_string<fil::fixed_string {"<"}, ast_object::operand> {}
+             | fil::copa::match_string<fil::fixed_string {"!="}, ast_object::operand> {}
+             | fil::copa::match_string<fil::fixed_string {"=="}, ast_object::operand> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_object> {2}; }
+};
+
+struct base_language_grammar {
+    using ast_object = ast_node;
+
+    static constexpr fil::copa::rule auto rules();
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_object> {0}; }
+};
+
+struct language_grammar {
+    using ast_object = ast_node;
+
+    static constexpr auto rules() {
+        return fil::copa::list_rule<fil::copa::or_rule<     //
+            fil::copa::match_parser<base_language_grammar>, //
+            fil::copa::match_parser<compare_grammar>,       //
+            fil::copa::match_parser<link_grammar>           //
+            >> {};
+    }
+    static constexpr auto convertor() { return fil::copa::sink::ast_tree_generator<ast_node> {0}; }
+};
+
+constexpr fil::copa::rule auto base_language_grammar::rules() {
+    return fil::copa::match_number<ast_node::leaf> {}                       //
+         | fil::copa::match_production<variable_grammar, ast_node::leaf> {} //
+         | fil::copa::parenthesised(fil::copa::match_production<language_grammar, ast_node::leaf> {});
+}
+
+struct program_grammar {
+    struct ast_object {
+        std::vector<ast_node> statements;
+    };
+
+    static constexpr auto rules() {
+        return fil::copa::list(fil::copa::match_production<language_grammar, fil::copa::member<&ast_object::statements>> {} //
+                               + fil::copa::semicol);
+    }
+    static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+};
+
+std::string generate(fil::rng& rng, std::size_t target_size) {
+    static constexpr std::array variables {"chocobo", "moogle", "cactuar", "tonberry", "x"};
+    static constexpr std::array accesses {"fly", "speed", "hp", "level"};
+    static constexpr std::array comparators {" >= ", " > ", " <= ", " < ", " != ", " == "};
+    static constexpr std::array links {" && ", " || "};
+
+    const auto operand = [&](std::string& content) {
+        if (rng.generate_in_range(0, 2) == 0) {
+            std::format_to(std::back_inserter(content), "{}", rng.generate_in_range(0, 9999));
+        } else if (rng.generate_in_range(0, 1) == 0) {
+            content += variables[rng.generate_in_range(0, 4)];
+        } else {
+            std::format_to(std::back_inserter(content), "{}.{}", variables[rng.generate_in_range(0, 4)], accesses[rng.generate_in_range(0, 3)]);
+        }
+    };
+    const auto comparison = [&](std::string& content) {
+        operand(content);
+        content += comparators[rng.generate_in_range(0, 5)];
+        operand(content);
+    };
+
+    std::string content;
+    content.reserve(target_size + 128);
+    while (content.size() < target_size) {
+        const auto conditions = rng.generate_in_range(1, 4);
+        for (int i = 0; i < conditions; ++i) {
+            if (i != 0)
+                content += links[rng.generate_in_range(0, 1)];
+            if (rng.generate_in_range(0, 4) == 0) {
+                content += '(';
+                comparison(content);
+                content += links[rng.generate_in_range(0, 1)];
+                comparison(content);
+                content += ')';
+            } else {
+                comparison(content);
+            }
+        }
+        content += ";\n";
+    }
+    return content;
+}
+
+/**
+ * @brief recursive descent parser counting the number of node (operand and operator) of each statement
+ */
+class baseline : baseline_scanner {
+  public:
+    using baseline_scanner::baseline_scanner;
+
+    std::optional<std::vector<std::size_t>> parse() {
+        std::vector<std::size_t> results;
+        while (!at_end_()) {
+            const auto nodes = expression_();
+            if (!nodes.has_value() || !consume_(";"))
+                return std::nullopt;
+            results.push_back(*nodes);
+        }
+        return results;
+    }
+
+  private:
+    static constexpr std::array operators {"&&", "||", ">=", ">", "<=", "<", "!=", "=="};
+
+    std::optional<std::size_t> expression_() {
+        auto nodes = operand_();
+        while (nodes.has_value() && std::ranges::any_of(operators, [this](std::string_view op) { return consume_(op); })) {
+            const auto rhs = operand_();
+            if (!rhs.has_value())
+                return std::nullopt;
+            nodes = *nodes + *rhs + 1;
+        }
+        return nodes;
+    }
+
+    std::optional<std::size_t> operand_() {
+        if (consume_("(")) {
+            const auto nodes = expression_();
+            return consume_(")") ? nodes : std::nullopt;
+        }
+        if (number_().has_value())
+            return 1;
+        if (identifier_().empty())
+            return std::nullopt;
+        if (consume_(".") && identifier_().empty())
+            return std::nullopt;
+        return 1;
+    }
+};
+
+} // namespace language
+
+//
+// json_like : flat json object of string / number
+//
+namespace json_like {
+
+struct entry {
+    std::string key;
+    int number = 0;
+    std::string text;
+};
+
+struct entry_grammar {
+    using ast_object = entry;
+
+    static constexpr auto rules() {
+        return fil::copa::apostrophed(fil::copa::match_identifier<fil::copa::member<&ast_object::key>> {}) //
+             + fil::copa::double_point                                                                   //
+             + (fil::copa::match_number<fil::copa::member<&ast_object::number>> {}                       //
+                | fil::copa::match_identifier<fil::copa::member<&ast_object::text>> {})                  //
+             + fil::copa::comma;
+    }
+    static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+};
+
+struct document_grammar {
+    struct ast_object {
+        std::vector<entry> entries;
+    };
+
+    static constexpr auto rules() {
+        return fil::copa::bracketed(fil::copa::list(fil::copa::match_parser<entry_grammar, fil::copa::member<&ast_object::entries>> {}));
+    }
+    static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+};
+
+std::string generate(fil::rng& rng, std::size_t target_size) {
+    static constexpr std::array words {"chocobo", "moogle", "cactuar", "tonberry", "bahamut", "ifrit"};
+
+    std::string content = "{\n";
+    content.reserve(target_size + 128);
+    for (std::size_t index = 0; content.size() < target_size; ++index) {
+        if (rng.generate_in_range(0, 1) == 0) {
+            std::format_to(std::back_inserter(content), "  \"key{}\": {},\n", index, rng.generate_in_range(0, 99999));
+        } else {
+            std::format_to(std::back_inserter(content), "  \"key{}\": {},\n", index, words[rng.generate_in_range(0, 5)]);
+        }
+    }
+    content += "}\n";
+    return content;
+}
+
+class baseline : baseline_scanner {
+  public:
+    using baseline_scanner::baseline_scanner;
+
+    std::optional<std::vector<entry>> parse() {
+        std::vector<entry> entries;
+        if (!consume_("{"))
+            return std::nullopt;
+        while (!consume_("}")) {
+            entry e;
+            if (!consume_("\""))
+                return std::nullopt;
+            e.key = identifier_();
+            if (!consume_("\"") || !consume_(":"))
+                return std::nullopt;
+            if (const auto number = number_(); number.has_value()) {
+                e.number = static_cast<int>(*number);
+            } else {
+                e.text = identifier_();
+            }
+            if (!consume_(","))
+                return std::nullopt;
+            entries.push_back(std::move(e));
+        }
+        return entries;
+    }
+};
+
+} // namespace json_like
+
+//
+// benchmark runner
+//
+
+struct bench_config {
+    std::size_t min_size = 1024;
+    std::size_t max_size = 64ull * 1024 * 1024;
+    std::size_t budget   = 64ull * 1024 * 1024; //!< number of byte parsed per case, small inputs are parsed several times
+    std::string grammar;                         //!< run only this grammar if not empty
+    std::string output;                          //!< json report file, standard output if empty
+};
+
+struct bench_result {
+    std::string grammar;
+    std::string input;
+    std::size_t size        = 0;
+    std::size_t iterations  = 0;
+    double seconds          = 0;
+    std::size_t allocations = 0;
+    long peak_rss_kb        = 0;
+    bool peak_rss_per_case  = true; //!< false if the peak couldn't be reset: peak_rss_kb is the peak of the process so far
+    bool success            = true;
+
+    [[nodiscard]] double mb_per_s() const { return seconds == 0 ? 0 : static_cast<double>(size * iterations) / seconds / 1e6; }
+    [[nodiscard]] double allocations_per_byte() const { return static_cast<double>(allocations) / static_cast<double>(size * iterations); }
+};
+
+std::size_t parse_size(std::string_view size) {
+    std::size_t unit = 1;
+    if (size.ends_with('K') || size.ends_with('k'))
+        unit = 1024;
+    else if (size.ends_with('M') || size.ends_with('m'))
+        unit = 1024 * 1024;
+    else if (size.ends_with('G') || size.ends_with('g'))
+        unit = 1024 * 1024 * 1024;
+    if (unit != 1)
+        size.remove_suffix(1);
+    return std::stoull(std::string {size}) * unit;
+}
+
+/**
+ * @brief reset the peak resident set size of the process (VmHWM) to its current resident set size
+ * @return false if the peak can't be reset (no procfs, kernel older than 4.0)
+ */
+bool reset_peak_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    return static_cast<bool>(clear_refs << "5" << std::flush);
+}
+
+/**
+ * @return peak resident set size of the process since the last @c reset_peak_rss (since its start if it never succeeded)
+ */
+long peak_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);) {
+        if (line.starts_with("VmHWM:")) {
+            return std::stol(line.substr(std::string_view {"VmHWM:"}.size()));
+        }
+    }
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief run a benchmark case
+ * @param setup create the input of one iteration (neither timed nor allocation counted)
+ * @param run parse the input, return true if the parsing succeeded
+ */
+bench_result run_case(std::string grammar, std::string input, std::size_t size, std::size_t iterations, auto&& setup, auto&& run) {
+    bench_result result {.grammar = std::move(grammar), .input = std::move(input), .size = size, .iterations = iterations};
+    result.peak_rss_per_case = reset_peak_rss();
+
+    for (std::size_t i = 0; i < iterations; ++i) {
+        auto in = setup();
+
+        const auto allocation_before = allocation_count.load(std::memory_order_relaxed);
+        const auto start             = std::chrono::steady_clock::now();
+        result.success &= run(std::move(in));
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.allocations += allocation_count.load(std::memory_order_relaxed) - allocation_before;
+    }
+    result.peak_rss_kb = peak_rss_kb();
+    return result;
+}
+
+template<typename Production, typename Baseline>
+void bench_grammar(const bench_config& config, const std::string& name, auto&& generate, std::vector<bench_result>& results) {
+    if (!config.grammar.empty() && config.grammar != name)
+        return;
+
+    fil::rng rng(42);
+    for (std::size_t size = config.min_size; size <= config.max_size; size *= 16) {
+        const std::string content = generate(rng, size);
+        const auto iterations     = std::clamp<std::size_t>(config.budget / content.size(), 1, 10'000);
+
+        results.push_back(run_case(
+            name, "baseline", content.size(), iterations, //
+            [&] { return std::string_view {content}; },
+            [](std::string_view in) { return Baseline {in}.parse().has_value(); }));
+
+        results.push_back(run_case(
+            name, "buffer_reader", content.size(), iterations, //
+            [&] { return fil::buffer_reader {std::string {content}}; },
+            [](fil::buffer_reader&& in) {
+                Production prod;
+                return fil::copa::parse(prod, std::move(in)).has_value();
+            }));
+
+        const fil::memory_file file(content, "copa_bench_" + name); // in memory: the reads don't measure the disk
+        results.push_back(run_case(
+            name, "file_reader", content.size(), iterations, //
+            [&] { return fil::file_reader {file.path()}; },
+            [](fil::file_reader&& in) {
+                Production prod;
+                return fil::copa::parse(prod, std::move(in)).has_value();
+            }));
+    }
+}
+
+std::string to_json(const std::vector<bench_result>& results) {
+    std::string json = "{\n  \"benchmark\": \"copa\",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+
+        // the baseline case of a (grammar, size) is always ran first
+        const auto baseline = std::ranges::find_if(results, [&r](const auto& b) {
+            return b.input == "baseline" && b.grammar == r.grammar && b.size == r.size;
+        });
+        const double baseline_ratio = baseline->mb_per_s() == 0 ? 0 : r.mb_per_s() / baseline->mb_per_s();
+
+        std::format_to(std::back_inserter(json),
+                       "{}\n    {{\"grammar\": \"{}\", \"input\": \"{}\", \"size\": {}, \"iterations\": {}, \"success\": {}, "
+                       "\"mb_per_s\": {:.3f}, \"baseline_ratio\": {:.4f}, \"allocations_per_byte\": {:.4f}, \"peak_rss_kb\": {}, "
+                       "\"peak_rss_per_case\": {}}}",
+                       i == 0 ? "" : ",", r.grammar, r.input, r.size, r.iterations, r.success, r.mb_per_s(), baseline_ratio,
+                       r.allocations_per_byte(), r.peak_rss_kb, r.peak_rss_per_case);
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench_config config;
+    std::string min_size;
+    std::string max_size;
+    std::string budget;
+
+    fil::command_line_interface cli(
+        [&] {
+            if (!min_size.empty())
+                config.min_size = parse_size(min_size);
+            if (!max_size.empty())
+                config.max_size = parse_size(max_size);
+            if (!budget.empty())
+                config.budget = parse_size(budget);
+
+            std::vector<bench_result> results;
+            bench_grammar<calculator::program_grammar, calculator::baseline>(config, "calculator", calculator::generate, results);
+            bench_grammar<language::program_grammar, language::baseline>(config, "language", language::generate, results);
+            bench_grammar<json_like::document_grammar, json_like::baseline>(config, "json", json_like::generate, results);
+
+            const auto report = to_json(results);
+            if (config.output.empty()) {
+                std::print("{}", report);
+            } else {
+                std::ofstream(config.output) << report;
+            }
+        },
+        "copa throughput benchmark : calculator, language and json-like grammars against a hand-written baseline parser");
+
+    fil::cli::add_argument_option(cli, "--min-size", min_size, "smallest generated input (default 1K), sizes grow by x16 up to --max-size");
+    fil::cli::add_argument_option(cli, "--max-size", max_size, "biggest generated input (default 64M, 1G for the full suite)");
+    fil::cli::add_argument_option(cli, "--budget", budget, "number of bytes parsed per case, small inputs are parsed several times (default 64M)");
+    fil::cli::add_argument_option(cli, "--grammar", config.grammar, "run only the given grammar (calculator, language or json)");
+    fil::cli::add_argument_option(cli, "--output", config.output, "json report file (default to standard output)");
+
+    cli.parse_command_line(argc, argv);
+    return 0;
+}
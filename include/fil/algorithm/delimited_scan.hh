@@ -0,0 +1,252 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_DELIMITED_SCAN_HH
+#define FIL_DELIMITED_SCAN_HH
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+namespace fil {
+
+// Delimited (CSV, TSV...) records scanning.
+//
+// The content is scanned by blocks of 64 bytes in two passes: the first one computes the bitmasks of the quotes, the
+// delimiters and the ends of line of the block (AVX2 or SSE2 comparisons when available at compile time, scalar loop
+// otherwise). The second one computes the mask of the quoted regions as the prefix xor of the quotes (carry-less
+// multiplication when PCLMUL is available) carried over from block to block: the delimiters and ends of line outside of
+// the quoted regions are the structural characters, iterated bit per bit to emit the fields.
+//
+// Escaped quotes are doubled quotes (RFC 4180): they don't change the parity of the quotes, and are left as is in the
+// fields (@see unescape_field).
+
+/**
+ * @brief characters of a delimited format
+ */
+struct csv_dialect {
+    char delimiter = ','; //!< separator of the fields
+    char quote     = '"'; //!< character enclosing the fields containing delimiters, quotes or ends of line
+};
+
+namespace details_ {
+
+struct structural_masks {
+    std::uint64_t quotes;     //!< bit set for each quote of the block
+    std::uint64_t delimiters; //!< bit set for each delimiter of the block
+    std::uint64_t newlines;   //!< bit set for each end of line of the block
+};
+
+/**
+ * @param block 64 bytes to compute the masks of
+ */
+[[nodiscard]] inline structural_masks compute_masks(const char* block, const csv_dialect& dialect) {
+    structural_masks masks {};
+#if defined(__AVX2__)
+    const __m256i quote     = _mm256_set1_epi8(dialect.quote);
+    const __m256i delimiter = _mm256_set1_epi8(dialect.delimiter);
+    const __m256i newline   = _mm256_set1_epi8('\n');
+    for (int half = 0; half < 2; ++half) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half * 32));
+        const auto shift    = half * 32;
+        masks.quotes |= std::uint64_t {static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)))} << shift;
+        masks.delimiters |= std::uint64_t {static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, delimiter)))} << shift;
+        masks.newlines |= std::uint64_t {static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)))} << shift;
+    }
+#elif defined(__SSE2__)
+    const __m128i quote     = _mm_set1_epi8(dialect.quote);
+    const __m128i delimiter = _mm_set1_epi8(dialect.delimiter);
+    const __m128i newline   = _mm_set1_epi8('\n');
+    for (int quarter = 0; quarter < 4; ++quarter) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + quarter * 16));
+        const auto shift    = quarter * 16;
+        masks.quotes |= std::uint64_t {static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))} << shift;
+        masks.delimiters |= std::uint64_t {static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, delimiter)))} << shift;
+        masks.newlines |= std::uint64_t {static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)))} << shift;
+    }
+#else
+    for (int i = 0; i < 64; ++i) {
+        const auto bit = std::uint64_t {1} << i;
+        masks.quotes |= block[i] == dialect.quote ? bit : 0;
+        masks.delimiters |= block[i] == dialect.delimiter ? bit : 0;
+        masks.newlines |= block[i] == '\n' ? bit : 0;
+    }
+#endif
+    return masks;
+}
+
+/**
+ * @return mask where each bit is the xor of all the bits of the input up to it (included): the quoted regions
+ */
+[[nodiscard]] inline std::uint64_t prefix_xor(std::uint64_t bits) {
+#if defined(__PCLMUL__)
+    const __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(bits)), _mm_set1_epi8(-1), 0);
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(product));
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+#endif
+}
+
+} // namespace details_
+
+/**
+ * @brief remove the escaping of the doubled quotes of a field
+ * @param field content of a quoted field (without its enclosing quotes)
+ * @param quote quote character of the dialect
+ * @return field with the doubled quotes replaced by a single quote
+ */
+[[nodiscard]] inline std::string unescape_field(std::string_view field, char quote = '"') {
+    std::string unescaped;
+    unescaped.reserve(field.size());
+    for (std::size_t i = 0; i < field.size(); ++i) {
+        unescaped.push_back(field[i]);
+        if (field[i] == quote && i + 1 < field.size() && field[i + 1] == quote) {
+            ++i;
+        }
+    }
+    return unescaped;
+}
+
+/**
+ * @brief Scanner splitting a content into records of fields, without allocation per field.
+ *
+ * @details The content has to begin at the beginning of a record (outside of a quoted field). The fields are views on
+ * the content: the enclosing quotes of the quoted fields are removed, as well as the carriage return of a record ended
+ * by CRLF. Empty lines are skipped.
+ */
+class delimited_scanner {
+  public:
+    static constexpr std::size_t BLOCK_SIZE = 64; //!< number of bytes scanned at once (one bit per byte in the masks)
+
+    explicit delimited_scanner(std::string_view content, csv_dialect dialect = {})
+        : content_(content)
+        , dialect_(dialect) {}
+
+    /**
+     * @brief retrieve the fields of the next record of the content
+     * @param fields cleared then filled with the fields of the record (its capacity is re-used from a record to another)
+     * @return false if the end of the content is reached (no record retrieved)
+     */
+    bool next(std::vector<std::string_view>& fields) {
+        fields.clear();
+        while (record_start_ < content_.size()) {
+            std::size_t field_start = record_start_;
+            while (true) {
+                if (pending_ == 0 && !load_block_()) {
+                    // last record without end of line
+                    fields.push_back(make_field_(field_start, content_.size(), true));
+                    record_start_ = content_.size();
+                    return true;
+                }
+                const auto position = block_position_ + static_cast<std::size_t>(std::countr_zero(pending_));
+                pending_ &= pending_ - 1;
+
+                const bool end_of_record = content_[position] == '\n';
+                fields.push_back(make_field_(field_start, position, end_of_record));
+                field_start = position + 1;
+                if (end_of_record) {
+                    break;
+                }
+            }
+            const bool empty_line = fields.size() == 1 && fields.front().empty() && field_start - record_start_ <= 2;
+            record_start_         = field_start;
+            if (!empty_line) {
+                return true;
+            }
+            fields.clear();
+        }
+        return false;
+    }
+
+    /**
+     * @return position in the content of the beginning of the next record
+     */
+    [[nodiscard]] std::size_t position() const { return record_start_; }
+
+  private:
+    /**
+     * @brief compute the structural characters (delimiters and ends of line outside of the quotes) of the next block
+     * @return false if the end of the content is reached
+     */
+    bool load_block_() {
+        while (next_block_ < content_.size()) {
+            block_position_ = next_block_;
+            next_block_ += BLOCK_SIZE;
+
+            details_::structural_masks masks;
+            if (content_.size() - block_position_ >= BLOCK_SIZE) {
+                masks = details_::compute_masks(content_.data() + block_position_, dialect_);
+            } else {
+                char tail[BLOCK_SIZE] {}; // zero padded, a zero is never structural
+                std::memcpy(tail, content_.data() + block_position_, content_.size() - block_position_);
+                masks = details_::compute_masks(tail, dialect_);
+            }
+            const auto quoted = details_::prefix_xor(masks.quotes) ^ quoted_carry_;
+            quoted_carry_     = static_cast<std::uint64_t>(static_cast<std::int64_t>(quoted) >> 63); // all ones if the block ends quoted
+            pending_          = (masks.delimiters | masks.newlines) & ~quoted;
+            if (pending_ != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] std::string_view make_field_(std::size_t start, std::size_t end, bool last_of_record) const {
+        auto field = content_.substr(start, end - start);
+        if (last_of_record && field.ends_with('\r')) {
+            field.remove_suffix(1);
+        }
+        if (field.size() >= 2 && field.front() == dialect_.quote && field.back() == dialect_.quote) {
+            field = field.substr(1, field.size() - 2);
+        }
+        return field;
+    }
+
+  private:
+    std::string_view content_;         //!< content scanned
+    csv_dialect dialect_;              //!< characters of the format
+    std::size_t record_start_ {0};     //!< beginning of the next record
+    std::size_t next_block_ {0};       //!< position of the next block to scan
+    std::size_t block_position_ {0};   //!< position of the block currently iterated
+    std::uint64_t pending_ {0};        //!< structural characters of the current block not iterated yet
+    std::uint64_t quoted_carry_ {0};   //!< all ones if the previous block ended inside a quoted field
+};
+
+} // namespace fil
+
+#endif // FIL_DELIMITED_SCAN_HH
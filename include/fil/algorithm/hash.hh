@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FIL_HASH_HH
+#define FIL_HASH_HH
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace fil {
+
+namespace details_ {
+
+static constexpr std::uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static constexpr std::uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr std::uint64_t HASH_PRIME_3 = 0x165667B19E3779F9ULL;
+static constexpr std::uint64_t HASH_PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr std::uint64_t HASH_PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+template<typename T>
+[[nodiscard]] inline T read_unaligned(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+[[nodiscard]] constexpr std::uint64_t hash_round(std::uint64_t acc, std::uint64_t input) {
+    acc += input * HASH_PRIME_2;
+    acc = std::rotl(acc, 31);
+    return acc * HASH_PRIME_1;
+}
+
+[[nodiscard]] constexpr std::uint64_t hash_merge_round(std::uint64_t acc, std::uint64_t value) {
+    acc ^= hash_round(0, value);
+    return acc * HASH_PRIME_1 + HASH_PRIME_4;
+}
+
+} // namespace details_
+
+/**
+ * @brief fast non-cryptographic 64 bits hash of a content (implementation of the XXH64 algorithm).
+ *
+ * @details The content is consumed by stripes of 32 bytes on four independent accumulators, which lets the CPU pipeline
+ * the computation: hashing runs close to memory bandwidth on big inputs. It is meant to identify a content (cache key,
+ * change detection), never to be used for security purposes.
+ *
+ * @param content to hash
+ * @param seed of the hash
+ * @return 64 bits hash of the content
+ */
+[[nodiscard]] inline std::uint64_t hash_content(std::string_view content, std::uint64_t seed = 0) {
+    using namespace details_;
+
+    const char* data      = content.data();
+    const char* const end = data + content.size();
+    std::uint64_t hash    = 0;
+
+    if (content.size() >= 32) {
+        const char* const limit = end - 32;
+
+        std::uint64_t v1 = seed + HASH_PRIME_1 + HASH_PRIME_2;
+        std::uint64_t v2 = seed + HASH_PRIME_2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - HASH_PRIME_1;
+
+        do {
+            v1 = hash_round(v1, read_unaligned<std::uint64_t>(data));
+            v2 = hash_round(v2, read_unaligned<std::uint64_t>(data + 8));
+            v3 = hash_round(v3, read_unaligned<std::uint64_t>(data + 16));
+            v4 = hash_round(v4, read_unaligned<std::uint64_t>(data + 24));
+            data += 32;
+        } while (data <= limit);
+
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = hash_merge_round(hash, v1);
+        hash = hash_merge_round(hash, v2);
+        hash = hash_merge_round(hash, v3);
+        hash = hash_merge_round(hash, v4);
+    } else {
+        hash = seed + HASH_PRIME_5;
+    }
+
+    hash += static_cast<std::uint64_t>(content.size());
+
+    for (; data + 8 <= end; data += 8) {
+        hash ^= hash_round(0, read_unaligned<std::uint64_t>(data));
+        hash = std::rotl(hash, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+    if (data + 4 <= end) {
+        hash ^= static_cast<std::uint64_t>(read_unaligned<std::uint32_t>(data)) * HASH_PRIME_1;
+        hash = std::rotl(hash, 23) * HASH_PRIME_2 + HASH_PRIME_3;
+        data += 4;
+    }
+    for (; data < end; ++data) {
+        hash ^= static_cast<std::uint64_t>(static_cast<std::uint8_t>(*data)) * HASH_PRIME_5;
+        hash = std::rotl(hash, 11) * HASH_PRIME_1;
+    }
+
+    // final avalanche
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace fil
+
+#endif // FIL_HASH_HH
@@ -0,0 +1,181 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_LINE_SCAN_HH
+#define FIL_LINE_SCAN_HH
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace fil {
+
+// Line splitting kernels shared by the readers.
+//
+// The search of the next end of line relies on `memchr`, which is vectorized by the standard library
+// implementations (and benefits of the best instruction set available at runtime). The count of a character (ends of
+// line, quotes...) and the backward search of the previous end of line are done with AVX2 (32 bytes per iteration) or
+// SSE2 (16 bytes per iteration) comparisons when available at compile time, with a scalar fallback otherwise.
+
+namespace details_ {
+
+[[nodiscard]] inline std::size_t count_byte_scalar(const char* first, const char* last, char c) {
+    std::size_t count = 0;
+    for (; first < last; ++first) {
+        count += (*first == c) ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace details_
+
+/**
+ * @param first beginning of the range to search in
+ * @param last end of the range to search in
+ * @return pointer on the first end of line character of the range, last if there is none
+ */
+[[nodiscard]] inline const char* find_newline(const char* first, const char* last) {
+    if (first >= last) {
+        return last;
+    }
+    const auto* found = static_cast<const char*>(std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+    return found == nullptr ? last : found;
+}
+
+/**
+ * @param first beginning of the range to search in
+ * @param last end of the range to search in (searched backward from it)
+ * @return pointer on the last end of line character of the range, last if there is none
+ */
+[[nodiscard]] inline const char* find_last_newline(const char* first, const char* last) {
+    const char* it = last;
+#if defined(__AVX2__)
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; it - first >= 32; it -= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it - 32));
+        const auto mask     = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) {
+            return it - 1 - std::countl_zero(mask);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; it - first >= 16; it -= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it - 16));
+        const auto mask     = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) {
+            return it - 1 - std::countl_zero(mask);
+        }
+    }
+#endif
+    while (it > first) {
+        if (*--it == '\n') {
+            return it;
+        }
+    }
+    return last;
+}
+
+/**
+ * @param first beginning of the range to count in
+ * @param last end of the range to count in
+ * @param c character to count
+ * @return number of occurrences of the character in the range
+ */
+[[nodiscard]] inline std::size_t count_byte(const char* first, const char* last, char c) {
+    std::size_t count = 0;
+#if defined(__AVX2__)
+    const __m256i searched = _mm256_set1_epi8(c);
+    for (; last - first >= 32; first += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const auto mask     = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, searched)));
+        count += static_cast<std::size_t>(std::popcount(mask));
+    }
+#elif defined(__SSE2__)
+    const __m128i searched = _mm_set1_epi8(c);
+    for (; last - first >= 16; first += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const auto mask     = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, searched)));
+        count += static_cast<std::size_t>(std::popcount(mask));
+    }
+#endif
+    return count + details_::count_byte_scalar(first, last, c);
+}
+
+/**
+ * @param first beginning of the range to count in
+ * @param last end of the range to count in
+ * @return number of end of line characters in the range
+ */
+[[nodiscard]] inline std::size_t count_newlines(const char* first, const char* last) { return count_byte(first, last, '\n'); }
+
+/**
+ * @param content to count the lines of
+ * @return number of lines of the content (a last line without end of line character is counted)
+ */
+[[nodiscard]] inline std::size_t count_lines(std::string_view content) {
+    const auto newlines = count_newlines(content.data(), content.data() + content.size());
+    return newlines + (!content.empty() && content.back() != '\n' ? 1 : 0);
+}
+
+/**
+ * @brief split the beginning of a content into lines
+ * @param content to split, a last line without end of line character is split only if `with_last_line` is true
+ * @param lines filled with the lines found (without the end of line character), up to its size
+ * @param with_last_line true if the content ends with the end of the input (a last line without end of line is complete)
+ * @return pair of the number of lines filled and the number of bytes of the content consumed by these lines
+ */
+[[nodiscard]] inline std::pair<std::size_t, std::size_t> split_lines(std::string_view content, std::span<std::string_view> lines,
+                                                                      bool with_last_line = true) {
+    const char* begin = content.data();
+    const char* end   = begin + content.size();
+    const char* it    = begin;
+
+    std::size_t filled = 0;
+    while (filled < lines.size() && it < end) {
+        const char* found = find_newline(it, end);
+        if (found == end) {
+            if (!with_last_line) {
+                break;
+            }
+            lines[filled++] = std::string_view(it, static_cast<std::size_t>(end - it));
+            it              = end;
+            break;
+        }
+        lines[filled++] = std::string_view(it, static_cast<std::size_t>(found - it));
+        it              = found + 1;
+    }
+    return {filled, static_cast<std::size_t>(it - begin)};
+}
+
+} // namespace fil
+
+#endif // FIL_LINE_SCAN_HH
@@ -0,0 +1,432 @@
+/// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FIL_COPA_CACHE_HH
+#define FIL_COPA_CACHE_HH
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "fil/algorithm/hash.hh"
+#include "fil/copa/copa.hh"
+#include "fil/copa/sink.hh"
+#include "fil/file/mapped_file.hh"
+#include "fil/meta/buffer_reader.hh"
+#include "fil/meta/typename.hh"
+
+namespace fil::copa::snapshot {
+
+/**
+ * @brief binary output in which the snapshot of an object is encoded
+ */
+class output {
+  public:
+    void write(const void* data, std::size_t size) { buffer_.append(static_cast<const char*>(data), size); }
+
+    [[nodiscard]] const std::string& buffer() const& { return buffer_; }
+    [[nodiscard]] std::string buffer() && { return std::move(buffer_); }
+
+  private:
+    std::string buffer_;
+};
+
+/**
+ * @brief binary input from which the snapshot of an object is decoded
+ * @note every read is bound checked : a truncated or corrupted snapshot makes the decoding fail, never overflow
+ */
+class input {
+  public:
+    explicit input(std::string_view data)
+        : data_(data) {}
+
+    [[nodiscard]] bool read(void* data, std::size_t size) {
+        if (data_.size() < size) {
+            return false;
+        }
+        std::memcpy(data, data_.data(), size);
+        data_.remove_prefix(size);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t remaining() const { return data_.size(); }
+
+  private:
+    std::string_view data_;
+};
+
+/**
+ * @brief encode/decode a type into a snapshot.
+ *
+ * @details The generic implementation handles aggregates by encoding each of their members in order, which requires the
+ * support of structured binding packs (`__cpp_structured_bindings >= 202411L`): without it, aggregates have to be given a
+ * codec. A custom codec can be provided for any type by specializing this template with:
+ * - `static void encode(output&, const T&)`
+ * - `static bool decode(input&, T&)` returning false if the decoding failed
+ *
+ * Codecs are provided for arithmetic and enum types, `std::string`, `std::vector`, `std::optional`, `std::shared_ptr`,
+ * `std::variant`, `std::monostate`, @c fil::copa::debug_info and @c fil::copa::ast_node: ast trees are handled out of
+ * the box, whatever the compiler.
+ */
+template<typename T>
+struct codec {
+#if __cpp_structured_bindings >= 202411L
+    static_assert(std::is_aggregate_v<T>, "no snapshot codec for this type: fil::copa::snapshot::codec has to be specialized");
+
+    static void encode(output& out, const T& value) {
+        const auto& [... members] = value;
+        (codec<std::remove_cvref_t<decltype(members)>>::encode(out, members), ...);
+    }
+
+    static bool decode(input& in, T& value) {
+        auto& [... members] = value;
+        return (codec<std::remove_cvref_t<decltype(members)>>::decode(in, members) && ...);
+    }
+#else
+    static_assert(sizeof(T) == 0, "aggregate snapshot requires structured binding packs: fil::copa::snapshot::codec has to be specialized");
+#endif
+};
+
+template<typename T>
+requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+struct codec<T> {
+    static void encode(output& out, const T& value) { out.write(&value, sizeof(T)); }
+    static bool decode(input& in, T& value) { return in.read(&value, sizeof(T)); }
+};
+
+template<>
+struct codec<std::monostate> {
+    static void encode(output&, const std::monostate&) {}
+    static bool decode(input&, std::monostate&) { return true; }
+};
+
+template<>
+struct codec<std::string> {
+    static void encode(output& out, const std::string& value) {
+        codec<std::uint64_t>::encode(out, value.size());
+        out.write(value.data(), value.size());
+    }
+    static bool decode(input& in, std::string& value) {
+        std::uint64_t size = 0;
+        if (!codec<std::uint64_t>::decode(in, size) || size > in.remaining()) {
+            return false;
+        }
+        value.resize(size);
+        return in.read(value.data(), size);
+    }
+};
+
+template<typename T>
+struct codec<std::vector<T>> {
+    static void encode(output& out, const std::vector<T>& value) {
+        codec<std::uint64_t>::encode(out, value.size());
+        if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+            out.write(value.data(), value.size() * sizeof(T));
+        } else {
+            for (const auto& element : value) {
+                codec<T>::encode(out, element);
+            }
+        }
+    }
+    static bool decode(input& in, std::vector<T>& value) {
+        std::uint64_t size = 0;
+        if (!codec<std::uint64_t>::decode(in, size)) {
+            return false;
+        }
+        if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+            if (size > in.remaining() / sizeof(T)) {
+                return false;
+            }
+            value.resize(size);
+            return in.read(value.data(), size * sizeof(T));
+        } else {
+            value.clear();
+            value.reserve(std::min<std::uint64_t>(size, in.remaining()));
+            for (std::uint64_t i = 0; i < size; ++i) {
+                if (!codec<T>::decode(in, value.emplace_back())) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+};
+
+template<typename T>
+struct codec<std::optional<T>> {
+    static void encode(output& out, const std::optional<T>& value) {
+        codec<bool>::encode(out, value.has_value());
+        if (value.has_value()) {
+            codec<T>::encode(out, *value);
+        }
+    }
+    static bool decode(input& in, std::optional<T>& value) {
+        bool has_value = false;
+        if (!codec<bool>::decode(in, has_value)) {
+            return false;
+        }
+        if (!has_value) {
+            value.reset();
+            return true;
+        }
+        return codec<T>::decode(in, value.emplace());
+    }
+};
+
+template<typename T>
+struct codec<std::shared_ptr<T>> {
+    static void encode(output& out, const std::shared_ptr<T>& value) {
+        codec<bool>::encode(out, value != nullptr);
+        if (value != nullptr) {
+            codec<T>::encode(out, *value);
+        }
+    }
+    static bool decode(input& in, std::shared_ptr<T>& value) {
+        bool has_value = false;
+        if (!codec<bool>::decode(in, has_value)) {
+            return false;
+        }
+        if (!has_value) {
+            value.reset();
+            return true;
+        }
+        value = std::make_shared<T>();
+        return codec<T>::decode(in, *value);
+    }
+};
+
+template<>
+struct codec<debug_info> {
+    static void encode(output& out, const debug_info& value) {
+        codec<std::string>::encode(out, value.token);
+        codec<std::size_t>::encode(out, value.line);
+        codec<std::size_t>::encode(out, value.cursor);
+        codec<std::string>::encode(out, value.parsing_step);
+        codec<std::string>::encode(out, value.error_msg);
+    }
+    static bool decode(input& in, debug_info& value) {
+        return codec<std::string>::decode(in, value.token) && codec<std::size_t>::decode(in, value.line)
+            && codec<std::size_t>::decode(in, value.cursor) && codec<std::string>::decode(in, value.parsing_step)
+            && codec<std::string>::decode(in, value.error_msg);
+    }
+};
+
+template<ast_node_concept T>
+struct codec<T> {
+    static void encode(output& out, const T& value) {
+        codec<typename T::operand_type>::encode(out, value.value);
+        codec<typename T::node_type>::encode(out, value.lhs);
+        codec<typename T::node_type>::encode(out, value.rhs);
+    }
+    static bool decode(input& in, T& value) {
+        return codec<typename T::operand_type>::decode(in, value.value) && codec<typename T::node_type>::decode(in, value.lhs)
+            && codec<typename T::node_type>::decode(in, value.rhs);
+    }
+};
+
+template<typename... Ts>
+struct codec<std::variant<Ts...>> {
+    static void encode(output& out, const std::variant<Ts...>& value) {
+        codec<std::uint32_t>::encode(out, static_cast<std::uint32_t>(value.index()));
+        std::visit([&out]<typename T>(const T& alternative) { codec<T>::encode(out, alternative); }, value);
+    }
+    static bool decode(input& in, std::variant<Ts...>& value) {
+        std::uint32_t index = 0;
+        if (!codec<std::uint32_t>::decode(in, index) || index >= sizeof...(Ts)) {
+            return false;
+        }
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return ((Is == index && codec<std::variant_alternative_t<Is, std::variant<Ts...>>>::decode(in, value.template emplace<Is>()))
+                    || ...);
+        }(std::index_sequence_for<Ts...> {});
+    }
+};
+
+/**
+ * @return binary snapshot of the provided value
+ */
+template<typename T>
+[[nodiscard]] std::string serialize(const T& value) {
+    output out;
+    codec<T>::encode(out, value);
+    return std::move(out).buffer();
+}
+
+/**
+ * @param data binary snapshot previously made with @c serialize
+ * @return the value decoded from the snapshot, nullopt if the snapshot is corrupted or incomplete
+ */
+template<typename T>
+[[nodiscard]] std::optional<T> deserialize(std::string_view data) {
+    input in {data};
+    T value {};
+    if (!codec<T>::decode(in, value) || in.remaining() != 0) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace fil::copa::snapshot
+
+namespace fil::copa {
+
+namespace details_ {
+
+static constexpr std::array<char, 4> SNAPSHOT_MAGIC   = {'C', 'O', 'P', 'A'};
+static constexpr std::uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+/**
+ * @brief header prefixing every snapshot stored in the cache directory
+ */
+struct snapshot_header {
+    std::array<char, 4> magic {SNAPSHOT_MAGIC};
+    std::uint32_t format_version {SNAPSHOT_FORMAT_VERSION};
+    std::uint64_t key {0};
+};
+
+template<typename AstObject>
+std::optional<AstObject> load_snapshot(const std::filesystem::path& snapshot_path, std::uint64_t key) {
+    const mapped_file snapshot {snapshot_path};
+    if (!snapshot.is_open() || snapshot.size() < sizeof(snapshot_header)) {
+        return std::nullopt;
+    }
+
+    snapshot_header header;
+    std::memcpy(&header, snapshot.data(), sizeof(snapshot_header));
+    if (header.magic != SNAPSHOT_MAGIC || header.format_version != SNAPSHOT_FORMAT_VERSION || header.key != key) {
+        return std::nullopt;
+    }
+    return snapshot::deserialize<AstObject>(snapshot.view().substr(sizeof(snapshot_header)));
+}
+
+template<typename AstObject>
+void store_snapshot(const std::filesystem::path& snapshot_path, std::uint64_t key, const AstObject& value) {
+    std::error_code ec;
+    std::filesystem::create_directories(snapshot_path.parent_path(), ec);
+
+    // written on a temporary file renamed afterward: a concurrent reader never sees a partially written snapshot. The
+    // temporary file has a random name and is created only if it doesn't exist: concurrent writers (of the same process
+    // or not) never write the same temporary file
+    std::random_device rd;
+    std::mt19937_64 gen((static_cast<std::uint64_t>(rd()) << 32) ^ rd());
+
+    std::filesystem::path tmp_path;
+    std::ofstream file;
+    for (int attempt = 0; attempt < 16 && !file.is_open(); ++attempt) {
+        tmp_path = std::filesystem::path {snapshot_path}.concat(std::format(".{:016x}.tmp", gen()));
+        file.open(tmp_path, std::ios::binary | std::ios::out | std::ios::noreplace);
+    }
+    if (!file.is_open()) {
+        return;
+    }
+    {
+        const snapshot_header header {.key = key};
+        const auto payload = snapshot::serialize(value);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(snapshot_header));
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        file.close();
+        if (!file) {
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp_path, snapshot_path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+    }
+}
+
+} // namespace details_
+
+/**
+ * @brief Parses a file through a cache of binary snapshots of the parse results.
+ *
+ * @details The content of the input file is hashed (@c fil::hash_content) together with the production type name and a
+ * user provided schema version. The resulting key identifies a snapshot file in the cache directory:
+ * - on a hit, the snapshot is memory-mapped and decoded, the parsing is skipped altogether.
+ * - on a miss (or if the snapshot is corrupted), the content is parsed and the snapshot of the result is stored.
+ *
+ * Only successful parses are cached. Storing a snapshot is best effort: a failure to write in the cache directory
+ * doesn't fail the parse.
+ *
+ * The ast object of the production is encoded through @c fil::copa::snapshot::codec: aggregates, ast trees and standard
+ * containers are handled out of the box, a custom codec can be specialized for any other type.
+ *
+ * @param prod grammar production to parse the file with
+ * @param input_path path of the file to parse
+ * @param cache_directory directory containing the snapshots (created if needed)
+ * @param schema_version version of the ast object layout: to be changed in order to invalidate the existing snapshots
+ *                       when the ast object changes without the production type name changing
+ * @return the ast object resulting of the parse (or decoded from the cache), or the stack of error that occurred
+ */
+template<production Prod>
+std::expected<typename Prod::ast_object, error_stack> cached_parse(Prod& prod, const std::filesystem::path& input_path,
+                                                                   const std::filesystem::path& cache_directory,
+                                                                   std::uint32_t schema_version = 0) {
+    using ast_object = typename Prod::ast_object;
+
+    const mapped_file content {input_path};
+    if (!content.is_open()) {
+        return std::unexpected(error_stack {debug_info {
+            .token        = {},
+            .line         = 0,
+            .cursor       = 0,
+            .parsing_step = "cached_parse",
+            .error_msg    = std::format("cannot open input file {}", input_path.string()),
+        }});
+    }
+
+    const auto seed          = hash_content(meta::type_name<Prod>(), schema_version);
+    const auto key           = hash_content(content.view(), seed);
+    const auto snapshot_path = cache_directory / std::format("{:016x}.copa", key);
+
+    if (auto cached = details_::load_snapshot<ast_object>(snapshot_path, key)) {
+        return std::move(cached).value();
+    }
+
+    auto result = parse(prod, buffer_view_reader {content.view()});
+    if (result) {
+        details_::store_snapshot(snapshot_path, key, *result);
+    }
+    return result;
+}
+
+} // namespace fil::copa
+
+#endif // FIL_COPA_CACHE_HH
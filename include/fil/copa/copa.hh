@@ -24,7 +24,10 @@
 #ifndef FIL_DESCPA_H
 #define FIL_DESCPA_H
 
+#include <cstdint>
 #include <expected>
+#include <optional>
+#include <string>
 
 #include "fil/copa/debug.hh"
 #include "fil/copa/production.hh"
@@ -33,6 +36,17 @@
 
 namespace fil::copa {
 
+/**
+ * @brief result of a parse in recovery mode, @see fil::copa::parse_with_recovery
+ */
+template<typename Ast>
+struct recovered_parse {
+    Ast ast;            //!< ast object aggregating every part of the input parsed successfully
+    error_stack errors; //!< every error encountered during the parse, empty if the whole input has been parsed
+
+    [[nodiscard]] bool has_errors() const { return errors.size() != 0; }
+};
+
 namespace details_ {
 
 /**
@@ -101,6 +115,114 @@ std::expected<typename Prod::ast_object, error_stack> do_parse(rule_ctx<Reader,
     return do_parse_rule<typename Prod::ast_object>(ctx, formula, ignore);
 }
 
+/**
+ * @brief read the input until a character not matched by the ignore rule
+ * @return the character read, nullopt if the end of the input has been reached
+ */
+std::optional<std::uint8_t> next_meaningful_byte(auto& ctx, const rule auto& ignore) {
+    for (auto c = ctx.reader->next_byte(); c.has_value(); c = ctx.reader->next_byte()) {
+        if (c == '\n')
+            ctx.current_line += 1;
+        if (ignore.match(ctx, c.value()) != match_result::SUCCESS)
+            return c;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief skip the input until the synchronization rule matches, the parsing context is reset to parse a formula from scratch
+ * @param c first candidate of the synchronization (character on which the parsing failed), read from the input if nullopt
+ * @return true if a synchronization point has been found, false if the end of the input has been reached
+ */
+bool synchronize(auto& ctx, const rule auto& sync, std::optional<std::uint8_t> c) {
+    const auto reset = [&ctx] {
+        ctx.idx.assign(1, 0);
+        ctx.current_token.clear();
+    };
+
+    reset();
+    if (!c.has_value()) {
+        c = ctx.reader->next_byte();
+        if (c == '\n')
+            ctx.current_line += 1;
+    }
+    while (c.has_value()) {
+        ctx.current_token += static_cast<char>(c.value());
+
+        const auto result = sync.match(ctx, c.value());
+        if (result == match_result::SUCCESS) {
+            reset();
+            return true;
+        }
+        if (result == match_result::FAILURE) {
+            reset();
+        }
+
+        c = ctx.reader->next_byte();
+        if (c == '\n')
+            ctx.current_line += 1;
+    }
+    return false;
+}
+
+/**
+ * @brief parse the formula, on error skip to the next synchronization point and parse the formula again from there
+ *
+ * @details The convertor isn't reset in between two attempts: the result of each successful part of the input is
+ * aggregated in the same ast object. The non-recovering parsing path is followed as long as no error occurs, the
+ * synchronization only happens on the error path.
+ */
+template<typename Result>
+recovered_parse<Result> do_parse_rule_recovering(auto& ctx, const rule auto& formula, const rule auto& ignore, const rule auto& sync) {
+    error_stack errors;
+    bool resumed = false;
+
+    while (true) {
+        auto result = do_parse_rule<Result>(ctx, formula, ignore);
+
+        std::optional<std::uint8_t> resume = std::nullopt;
+        if (result.has_value()) {
+            resume = next_meaningful_byte(ctx, ignore);
+            if (!resume.has_value()) {
+                return {std::move(result.value()), std::move(errors)};
+            }
+            // the formula ended without consuming the whole input (e.g. a list stopping on an invalid element)
+            errors.push({
+                .token        = std::string(1, static_cast<char>(resume.value())),
+                .line         = ctx.current_line,
+                .cursor       = ctx.reader->reader_cursor(),
+                .parsing_step = meta::type_name<decltype(formula)>(),
+                .error_msg    = "unexpected input, skipped until the next synchronization point",
+            });
+        } else {
+            if (resumed && ctx.idx.size() == 1 && ctx.idx.back() == 0 && ctx.current_token.empty()) {
+                break; // only ignored characters remained after the last synchronization point
+            }
+            for (auto& error : result.error()) {
+                errors.push(std::move(error));
+            }
+            if (!ctx.current_token.empty()) {
+                resume = static_cast<std::uint8_t>(ctx.current_token.back());
+            }
+        }
+
+        ctx.err_stack.clear();
+        if (!synchronize(ctx, sync, resume)) {
+            break;
+        }
+        resumed = true;
+    }
+    return {ctx.convertor->value(ctx), std::move(errors)};
+}
+
+template<reader Reader, typename Convertor, recoverable_production Prod>
+recovered_parse<typename Prod::ast_object> do_parse_recovering(rule_ctx<Reader, Convertor>& ctx, const Prod& prod) {
+    const rule auto formula = prod.rules();
+    const rule auto ignore  = details_::retrieve_ignore_rules(prod);
+
+    return do_parse_rule_recovering<typename Prod::ast_object>(ctx, formula, ignore, Prod::sync());
+}
+
 template<reader Reader>
 class parser {
   public:
@@ -120,6 +242,19 @@ class parser {
         return details_::do_parse(ctx, prod);
     }
 
+    constexpr auto parse_with_recovery(const recoverable_production auto& prod) {
+        auto convertor = prod.convertor();
+        typename decltype(convertor)::ctx_extension ext;
+        rule_ctx ctx {
+            .reader         = &input_,
+            .convertor      = &convertor,
+            .convertor_ctx  = &ext,
+            .is_main_parser = true,
+        };
+
+        return details_::do_parse_recovering(ctx, prod);
+    }
+
     Reader&& get_reader() && { return std::move(input_); }
 
   private:
@@ -181,6 +316,166 @@ constexpr auto parse(production auto& prod, reader auto&& input) {
     return p.parse(prod);
 }
 
+/**
+ * @brief Parses input data according to a grammar production, resuming the parsing after each error.
+ *
+ * @details Instead of stopping at the first error, the parser records it, skips the input up to the next
+ * synchronization point (defined by the rule returned by the static member function @c Prod::sync(), typically a
+ * semicolon or a newline) and parses the production again from there. A single pass over the input returns every
+ * error along with the partial ast object, which is useful to validate a batch of files.
+ *
+ * The parsing follows the same path as @c fil::copa::parse until an error occurs: the recovery is only paid on the
+ * error path.
+ *
+ * @note The convertor of the production is kept in between each resumed parse: recovery is meant for productions
+ * aggregating a list of elements (statements, entries...) into their ast object. The elements failing to be parsed
+ * are skipped.
+ *
+ * @tparam Prod A type satisfying the `recoverable_production` concept
+ * @param prod The grammar production that defines parsing rules and result construction.
+ * @param input An rvalue reference to a `reader` object.
+ * @return @c recovered_parse containing the ast object and the stack of all the errors encountered
+ *
+ * @example
+ * @code
+ * struct statements_grammar {
+ *     struct ast_object {
+ *         std::vector<statement> statements;
+ *     };
+ *     static constexpr auto rules() {
+ *         return list(match_parser<statement_grammar, member<&ast_object::statements>> {});
+ *     }
+ *     static constexpr auto sync() { return semicol; }
+ *     static constexpr auto convertor() { return sink::aggregator<ast_object> {}; }
+ * };
+ *
+ * statements_grammar grammar;
+ * auto [ast, errors] = parse_with_recovery(grammar, fil::file_reader {path});
+ * @endcode
+ */
+template<recoverable_production Prod>
+constexpr auto parse_with_recovery(Prod& prod, reader auto&& input) {
+    details_::parser p(std::forward<decltype(input)>(input));
+    return p.parse_with_recovery(prod);
+}
+
+/**
+ * @brief Parser keeping its parsing context alive from one parse to another.
+ *
+ * @details Each call to @c fil::copa::parse builds a new convertor, a new convertor context extension and a new
+ * @c rule_ctx (depth index vector, current token string and error stack). For request-scoped parsing of many small
+ * inputs, those allocations dominate the parsing time.
+ *
+ * A `reusable_parser` owns all of those objects and only resets them in between two parses through @c reset, which
+ * keeps the capacity of the depth index and of the current token, and resets the convertor in place if it provides a
+ * `reset()` member function (as the convertors of @c fil::copa::sink do): once warm, a parse doesn't allocate anymore
+ * for its own bookkeeping.
+ *
+ * The allocations made by the rules themselves remain (errors pushed by failing alternatives, sub-context of the
+ * alternatives of an or_rule, copy of the convertor for a tuple alternative...), as well as the ones of the ast_object
+ * produced: a warm parse allocates less than @c fil::copa::parse, not nothing.
+ *
+ * @note The instance isn't synchronized; it is meant to be used per thread, typically as a `thread_local` variable.
+ * @note The instance is neither copyable nor movable as the parsing context references its own members.
+ *
+ * @tparam Prod production to parse
+ * @tparam Reader reader used as input of each parse
+ *
+ * @example
+ * @code
+ * thread_local fil::copa::reusable_parser<my_grammar, fil::buffer_reader> parser;
+ *
+ * auto result = parser.parse(fil::buffer_reader {std::move(message)});
+ * @endcode
+ */
+template<production Prod, reader Reader>
+class reusable_parser {
+  public:
+    using convertor_type = std::decay_t<decltype(Prod::convertor())>;
+    using result_type    = std::expected<typename Prod::ast_object, error_stack>;
+
+    /**
+     * @param depth_reserve number of nested depth pre-allocated in the parsing context
+     * @param token_reserve number of character pre-allocated for the current token of the parsing context
+     */
+    explicit reusable_parser(std::size_t depth_reserve = 16, std::size_t token_reserve = 64) {
+        ctx_.idx.reserve(depth_reserve);
+        ctx_.current_token.reserve(token_reserve);
+    }
+
+    reusable_parser(const reusable_parser&)            = delete;
+    reusable_parser& operator=(const reusable_parser&) = delete;
+
+    /**
+     * @brief reset the parsing context while keeping its already allocated buffers and set a new input to parse
+     * @param input reader to parse on the next call to @c parse()
+     */
+    void reset(Reader input) {
+        if (input_.has_value()) {
+            *input_ = std::move(input);
+        } else {
+            input_.emplace(std::move(input));
+        }
+        if constexpr (requires { convertor_.reset(); }) {
+            convertor_.reset();
+        } else {
+            convertor_ = Prod::convertor();
+        }
+        ext_ = {};
+
+        ctx_.reader         = &*input_;
+        ctx_.convertor      = &convertor_;
+        ctx_.convertor_ctx  = &ext_;
+        ctx_.current_line   = 1;
+        ctx_.is_main_parser = true;
+        ctx_.idx.assign(1, 0);
+        ctx_.current_token.clear();
+        ctx_.err_stack.clear();
+    }
+
+    /**
+     * @brief parse the input provided on the last @c reset call
+     * @return the ast object resulting of the parse, or the stack of error that occurred
+     */
+    result_type parse() {
+        if (!input_.has_value()) {
+            return std::unexpected(error_stack {debug_info {
+                .token        = {},
+                .line         = 0,
+                .cursor       = 0,
+                .parsing_step = meta::type_name<reusable_parser>(),
+                .error_msg    = "reusable_parser : no input set, reset() has to be called before parse()",
+            }});
+        }
+        return details_::do_parse(ctx_, Prod {});
+    }
+
+    /**
+     * @brief reset the parser with the provided input and parse it
+     * @param input reader to parse
+     * @return the ast object resulting of the parse, or the stack of error that occurred
+     */
+    result_type parse(Reader input) {
+        reset(std::move(input));
+        return parse();
+    }
+
+    /**
+     * @return reader used in the last parse if any, can be used to retrieve the cursor at which the parse ended
+     */
+    [[nodiscard]] const Reader* get_reader() const { return input_.has_value() ? &*input_ : nullptr; }
+
+  private:
+    std::optional<Reader> input_;
+    convertor_type convertor_ {Prod::convertor()};
+    typename convertor_type::ctx_extension ext_ {};
+
+    details_::rule_ctx<Reader, convertor_type> ctx_ {
+        .reader    = nullptr,
+        .convertor = nullptr,
+    };
+};
+
 } // namespace fil::copa
 
 #endif // FIL_DESCPA_H
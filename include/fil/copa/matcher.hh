@@ -237,9 +237,9 @@ struct match_parser : composable_rule {
  *
  * @details `match_production` allows the composition of multiple grammars by treating a complete
  * grammar production as a single matching rule, with a critical distinction from `match_parser`:
- * it creates a fully independent parsing context with a shallow-copied reader. This isolation
- * ensures that nested production parsing operates independently while maintaining synchronization
- * with the parent parser's reader position upon successful completion.
+ * it creates a fully independent parsing context. This isolation ensures that nested production parsing
+ * operates independently while maintaining synchronization with the parent parser's reader position upon
+ * successful completion.
  *
  * This isolation is beneficial in scenarios where nested productions require independent
  * state management or when backtracking safety is critical. The shallow copy provides efficiency
@@ -248,18 +248,23 @@ struct match_parser : composable_rule {
  * @par Distinction from match_parser
  * Unlike @c match_parser, which shares the parsing context (`rule_ctx`) with the parent parser:
  * - **match_parser**: Uses the same `rule_ctx`, reusing the parent's convertor context and reader reference
- * - **match_production**: Creates a completely new parser instance with a shallow-copied reader,
- *   resulting in an independent parsing context that doesn't share state with the parent.
+ * - **match_production**: Creates a completely new parsing context, resulting in an independent parsing context
+ *   that doesn't share state with the parent.
+ *
+ * @par Reader backtracking
+ * If the reader follows @c fil::meta::checkpoint_reader, the nested production is parsed directly on the parent
+ * reader, which is restored to its checkpoint if the parsing fails. Otherwise, the nested production is parsed on a
+ * shallow copy of the reader that is assigned back to the parent reader upon success.
  *
  * @par Parsing Behavior
  * When a `match_production` is encountered during parsing:
- * 1. The current reader state is shallow-copied to create an independent reader instance
- * 2. A new standalone parser is instantiated with the copied reader
+ * 1. The current reader state is saved (checkpoint or shallow copy of the reader)
+ * 2. A new standalone parsing context is instantiated
  * 3. The parser attempts to match the input against `Prod::rules()` with its own convertor instance
  * 4. If successful, the resulting `Prod::ast_object` is produced
  * 5. The result is passed to the member/callback specified by `Mem` in the parent context
- * 6. The parent reader is synchronized with the new parser's reader position upon success
- * 7. If parsing fails, the entire match fails and input is not consumed by the parent
+ * 6. The parent reader is synchronized with the nested parsing reader position upon success
+ * 7. If parsing fails, the entire match fails and input is not consumed by the parent (the reader is restored)
  *
  * @tparam Prod The grammar that will be matched. Must be a @c fil::copa::production type to be parsed as a nested rule.
  * @tparam Mem  The target member or callback where the parsed result will be stored.
@@ -281,24 +286,51 @@ struct match_production : composable_rule {
     static constexpr match_result match(auto& ctx, std::uint8_t, std::uint32_t = 0) {
         static_assert(production<Prod>, "type provided to a match_production must be a fil::copa::production.");
 
-        using shallow = shallow_copy<std::decay_t<decltype(*ctx.reader)>>;
-        auto reader   = shallow::copy(*ctx.reader);
+        using reader_type = std::decay_t<decltype(*ctx.reader)>;
+
+        if constexpr (meta::checkpoint_reader<reader_type>) {
+            // the production is parsed directly on the reader, which is rewound to its checkpoint in case of failure
+            const auto checkpoint = ctx.reader->checkpoint();
+            ctx.reader->previous_byte();
+
+            auto convertor = Prod::convertor();
+            typename decltype(convertor)::ctx_extension ext;
+            details_::rule_ctx ctx_production {
+                .reader         = ctx.reader,
+                .convertor      = &convertor,
+                .convertor_ctx  = &ext,
+                .is_main_parser = true,
+            };
+
+            auto res = details_::do_parse(ctx_production, Prod {});
+            if (!res) {
+                ctx.reader->restore(checkpoint);
+                return match_result::FAILURE;
+            }
 
-        reader.previous_byte();
+            ctx.convertor->operator()(ctx.convertor_ctx, Mem {}, std::move(res).value());
+            ctx.current_token = {};
 
-        auto parser = details_::parser {std::move(reader)};
-        auto prod   = Prod {};
-        auto res    = parser.parse(prod);
+        } else {
+            using shallow = shallow_copy<reader_type>;
+            auto reader   = shallow::copy(*ctx.reader);
 
-        if (!res) {
-            return match_result::FAILURE;
-        }
+            reader.previous_byte();
 
-        // Now pass the result to the convertor
-        ctx.convertor->operator()(ctx.convertor_ctx, Mem {}, std::move(res).value());
-        ctx.current_token = {};
+            auto parser = details_::parser {std::move(reader)};
+            auto prod   = Prod {};
+            auto res    = parser.parse(prod);
+
+            if (!res) {
+                return match_result::FAILURE;
+            }
 
-        shallow::assign(*ctx.reader, std::move(parser).get_reader());
+            // Now pass the result to the convertor
+            ctx.convertor->operator()(ctx.convertor_ctx, Mem {}, std::move(res).value());
+            ctx.current_token = {};
+
+            shallow::assign(*ctx.reader, std::move(parser).get_reader());
+        }
 
         return match_result::SUCCESS;
     }
@@ -323,7 +355,8 @@ struct match_production : composable_rule {
  *
  * @attention  Performance Considerations
  * - Each iteration performs a full rule evaluation, which may be expensive for complex rules
- * - Reader state is shallow-copied (see @c fil::shallow_copy for more details) on each iteration for backtracking safety
+ * - Reader state is saved on each iteration for backtracking safety: through a checkpoint if the reader follows
+ *   @c fil::meta::checkpoint_reader (constant cost), through a shallow copy otherwise (see @c fil::shallow_copy)
  * - The result vector grows dynamically as matches are found
  * - Early termination occurs as soon as the rule fails to be matched
  *
@@ -355,12 +388,7 @@ struct list_rule : composable_rule {
         ctx.reader->previous_byte(); // go back a character as we went forward before starting or
         ctx.current_token.pop_back();
 
-        using shallow    = shallow_copy<Reader>;
-        auto copy_reader = shallow::copy(*ctx.reader);
-        details_::rule_ctx reset_ctx {
-            .reader    = &copy_reader,
-            .convertor = ctx.convertor,
-        };
+        auto reader_state = details_::save_reader_state(*ctx.reader);
 
         ++ctx.idx.back();
         const auto current = details_::do_parse_rule<typename Convertor::value_type>(ctx, Rule {}, match_space_like {});
@@ -374,7 +402,7 @@ struct list_rule : composable_rule {
 
         ctx.decrease_depth();
 
-        shallow::assign(*ctx.reader, std::move(*reset_ctx.reader));
+        details_::rewind_reader_state(*ctx.reader, std::move(reader_state));
 
         return match_result::SUCCESS;
     }
@@ -46,6 +46,15 @@ concept production =                                           //
         { T::convertor() } -> generator;
     };
 
+/**
+ * @brief production declaring synchronization rules, used to resume the parsing after an error
+ * @see @c fil::copa::parse_with_recovery
+ */
+template<typename T>
+concept recoverable_production = production<T> && requires {
+    { T::sync() } -> rule;
+};
+
 /**
  * @tparam Prod production with extra requirements to provide ignore() returning a rule of character to ignore
  * @return rule defined by the production Prod::ignore static member function
@@ -83,6 +83,31 @@ struct rule_ctx {
     void decrease_depth() { idx.pop_back(); }
 };
 
+/**
+ * @brief save the state of a reader in order to rewind it after a failed attempt of a rule
+ * @return checkpoint of the reader if it follows @c meta::checkpoint_reader, a shallow copy of the reader otherwise
+ */
+template<reader Reader>
+constexpr auto save_reader_state(Reader& reader) {
+    if constexpr (meta::checkpoint_reader<Reader>) {
+        return reader.checkpoint();
+    } else {
+        return shallow_copy<Reader>::copy(reader);
+    }
+}
+
+/**
+ * @brief rewind a reader to a state saved with @c save_reader_state
+ */
+template<reader Reader, typename State>
+constexpr void rewind_reader_state(Reader& reader, State&& state) {
+    if constexpr (meta::checkpoint_reader<Reader>) {
+        reader.restore(state);
+    } else {
+        shallow_copy<Reader>::assign(reader, std::forward<State>(state));
+    }
+}
+
 } // namespace details_
 
 template<typename T>
@@ -215,37 +240,20 @@ struct or_rule {
     static constexpr match_result match(details_::rule_ctx<Reader, Convertor>& ctx, std::uint8_t, std::uint32_t = 0) {
 
         auto process = [&ctx]<rule Rule>() -> bool {
-            auto shallow_reader = shallow_copy<Reader>::copy(*ctx.reader);
-            auto* convertor     = ctx.convertor;
-
-            // if tuple, make a copy of the convertor for re-assignment at the end in case of error
-            // this is an inefficient path; it is not recommended to do or_rule with tuples_rule as the rollback in case of error is costly
-            std::unique_ptr<Convertor> convertor_copy = nullptr;
-            if constexpr (details_::is_tuple_rule<Rule>) {
-                convertor_copy = std::make_unique<Convertor>(*ctx.convertor);
-                convertor      = convertor_copy.get();
-            }
-
-            details_::rule_ctx ctx_or {
-                .reader        = &shallow_reader,
-                .convertor     = convertor,
-                .convertor_ctx = ctx.convertor_ctx,
-                .current_token = ctx.current_token,
-            };
-
-            ctx_or.reader->previous_byte(); // go back a character as we went forward before starting or
-            ctx_or.current_token.pop_back();
-
-            auto res = details_::do_parse_rule<typename Convertor::value_type>(ctx_or, Rule {}, details_::match_space_like {});
-            if (!res) {
-                return false;
-            }
-
-            ctx.current_token = {};
-            if constexpr (details_::is_tuple_rule<Rule>) {
-                *ctx.convertor = std::move(*ctx_or.convertor);
+            if constexpr (meta::checkpoint_reader<Reader>) {
+                // the alternative is attempted directly on the reader, which is rewound to its checkpoint in case of failure
+                const auto checkpoint = ctx.reader->checkpoint();
+                if (!attempt_alternative_<Rule>(ctx, ctx.reader)) {
+                    ctx.reader->restore(checkpoint);
+                    return false;
+                }
+            } else {
+                auto shallow_reader = shallow_copy<Reader>::copy(*ctx.reader);
+                if (!attempt_alternative_<Rule>(ctx, &shallow_reader)) {
+                    return false;
+                }
+                shallow_copy<Reader>::assign(*ctx.reader, std::move(shallow_reader));
             }
-            shallow_copy<Reader>::assign(*ctx.reader, std::move(*ctx_or.reader));
             return true;
         };
 
@@ -266,6 +274,46 @@ struct or_rule {
     }
 
   private:
+    /**
+     * @brief attempt to parse an alternative of the or rule
+     * @param ctx context of the or rule
+     * @param reader reader on which the alternative is parsed
+     * @return true if the alternative has been successfully parsed, false otherwise
+     */
+    template<rule Rule, reader Reader, typename Convertor>
+    static constexpr bool attempt_alternative_(details_::rule_ctx<Reader, Convertor>& ctx, Reader* reader) {
+        auto* convertor = ctx.convertor;
+
+        // if tuple, make a copy of the convertor for re-assignment at the end in case of error
+        // this is an inefficient path; it is not recommended to do or_rule with tuples_rule as the rollback in case of error is costly
+        std::unique_ptr<Convertor> convertor_copy = nullptr;
+        if constexpr (details_::is_tuple_rule<Rule>) {
+            convertor_copy = std::make_unique<Convertor>(*ctx.convertor);
+            convertor      = convertor_copy.get();
+        }
+
+        details_::rule_ctx ctx_or {
+            .reader        = reader,
+            .convertor     = convertor,
+            .convertor_ctx = ctx.convertor_ctx,
+            .current_token = ctx.current_token,
+        };
+
+        ctx_or.reader->previous_byte(); // go back a character as we went forward before starting or
+        ctx_or.current_token.pop_back();
+
+        auto res = details_::do_parse_rule<typename Convertor::value_type>(ctx_or, Rule {}, details_::match_space_like {});
+        if (!res) {
+            return false;
+        }
+
+        ctx.current_token = {};
+        if constexpr (details_::is_tuple_rule<Rule>) {
+            *ctx.convertor = std::move(*ctx_or.convertor);
+        }
+        return true;
+    }
+
     std::size_t idx_ = 0;
 };
 
@@ -121,6 +121,17 @@ class aggregator {
         return value_;
     }
 
+    /**
+     * @brief reset the aggregated value for a new parse, in place: a container value keeps its capacity
+     */
+    constexpr void reset() {
+        if constexpr (requires { value_.clear(); }) {
+            value_.clear();
+        } else {
+            value_ = value_type {};
+        }
+    }
+
   private:
     value_type value_ {};
 };
@@ -132,6 +143,7 @@ struct convertor_noop {
 
     constexpr void operator()(void*, const auto&, auto&&) {}
     constexpr value_type value(auto&) const { return {}; }
+    constexpr void reset() {}
 };
 
 /**
@@ -244,6 +256,9 @@ class ast_tree_generator {
         return value_node;
     }
 
+    //! the tree is built in the ctx_extension: the generator itself has nothing to reset in between two parses
+    constexpr void reset() {}
+
   private:
     std::uint32_t precedence_; //!< precedence of the current instance of the generator, tree construction depends on that difference
 };
@@ -24,9 +24,15 @@
 #define SOA_H
 
 #include <algorithm>
+#include <bit>
+#include <concepts>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <new>
+#include <optional>
 #include <ostream>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -55,6 +61,61 @@ static constexpr std::size_t parameter_pack_index = 1 + parameter_pack_index<T,
 template<typename T, typename... Ts>
 static constexpr std::size_t parameter_pack_index<T, T, Ts...> = 0;
 
+/**
+ * @brief allocator of memory aligned on `alignment` bytes, the size of the allocations being padded to a multiple of the
+ * alignment (a kernel can load a whole vector register at the end of an array without going out of its allocation)
+ */
+template<typename T, std::size_t alignment>
+struct aligned_allocator {
+    static_assert(std::has_single_bit(alignment) && alignment >= alignof(T), "alignment must be a power of two, at least alignof(T)");
+
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = aligned_allocator<U, alignment>;
+    };
+
+    aligned_allocator() = default;
+
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, alignment>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) { return static_cast<T*>(::operator new(padded_size_(n), std::align_val_t {alignment})); }
+
+    void deallocate(T* data, std::size_t n) noexcept { ::operator delete(data, padded_size_(n), std::align_val_t {alignment}); }
+
+    template<typename U>
+    bool operator==(const aligned_allocator<U, alignment>&) const noexcept {
+        return true;
+    }
+
+  private:
+    static constexpr std::size_t padded_size_(std::size_t n) { return (n * sizeof(T) + alignment - 1) / alignment * alignment; }
+};
+
+/**
+ * @brief column policy of a soa: columns allocated with the standard allocator
+ */
+struct default_columns {
+    template<typename T>
+    using allocator = std::allocator<T>;
+
+    static constexpr std::size_t alignment = 0; //!< alignment of the columns, 0 if no more than the alignment of their type
+};
+
+/**
+ * @brief column policy of a soa: columns aligned (and padded) on `Alignment` bytes, e.g. 64 for cache line (and AVX-512)
+ * aligned kernels
+ */
+template<std::size_t Alignment>
+struct aligned_columns {
+    template<typename T>
+    using allocator = aligned_allocator<T, Alignment>;
+
+    static constexpr std::size_t alignment = Alignment; //!< alignment of the columns
+};
+
 template<typename T>
 class soa_struct_t {
     friend T;
@@ -83,11 +144,12 @@ class soa_struct_t {
  * store the individual components of a structure, enabling efficient processing
  * of large datasets.
  *
+ * @tparam column_policy allocator and alignment of the columns (@see default_columns, aligned_columns)
  * @tparam struct_types Variadic template parameter pack representing the types
  * of elements present in each structure.
  */
-template<typename... struct_types>
-class soa {
+template<typename column_policy, typename... struct_types>
+class basic_soa {
 
   public:
     //! number of elements in the structure handled by the soa class
@@ -100,7 +162,7 @@ class soa {
     /**
      * struct entity retrieve through a SOA access
      */
-    using soa_struct = soa_struct_t<soa>;
+    using soa_struct = soa_struct_t<basic_soa>;
 
     /**
      * @brief id of a structure in the soa. A structure is composed of each element of the soa class.
@@ -119,8 +181,8 @@ class soa {
     class iterator_t;
 
     struct sentinel {};                           //!< sentinel used for end iteration over a soa
-    using iterator       = iterator_t<soa>;       //!< iterator declaration following standard
-    using const_iterator = iterator_t<const soa>; //!< iterator declaration following standard
+    using iterator       = iterator_t<basic_soa>;       //!< iterator declaration following standard
+    using const_iterator = iterator_t<const basic_soa>; //!< iterator declaration following standard
 
     using struct_number = std::index_sequence_for<struct_types...>;
 
@@ -128,7 +190,7 @@ class soa {
     //! setup soa_struct as a friend class to provide the ability for soa class to instantiate it
     template<typename>
     friend class soa_struct_t;
-    using const_soa_struct = soa_struct_t<const soa>;
+    using const_soa_struct = soa_struct_t<const basic_soa>;
 
   public:
     /**
@@ -158,12 +220,74 @@ class soa {
      */
     void reserve(std::size_t size);
 
+    /**
+     * @note the id is not checked (undefined behavior if the soa doesn't contain it), @see at
+     * @return structure of the provided id
+     */
     [[nodiscard]] soa_struct operator[](struct_id);
     [[nodiscard]] const_soa_struct operator[](struct_id) const;
 
-    // [[nodiscard]] const_row operator[](row_id k) const;
+    /**
+     * @brief checked access to a structure, in constant time
+     * @param id of the structure to retrieve
+     * @return structure of the provided id, nullopt if the soa doesn't contain it (erased, or never inserted)
+     */
+    [[nodiscard]] std::optional<soa_struct> at(struct_id id);
+    [[nodiscard]] std::optional<const_soa_struct> at(struct_id id) const;
+
+    /**
+     * @brief contiguous access to a column, without indirection through the ids (the structures are in the order of the
+     * iteration, an erase moves the last structure in place of the erased one)
+     * @tparam index of the column
+     * @return span on the elements of the column, invalidated by an insert or an erase
+     */
+    template<std::size_t index>
+    [[nodiscard]] std::span<struct_type_at<index>> column();
+    template<std::size_t index>
+    [[nodiscard]] std::span<const struct_type_at<index>> column() const;
+
+    /**
+     * @tparam T type of the column, appearing once in the types of the soa
+     * @return span on the elements of the column of type T
+     */
+    template<typename T>
+        requires((std::is_same_v<T, struct_types> + ...) == 1)
+    [[nodiscard]] std::span<T> column();
+    template<typename T>
+        requires((std::is_same_v<T, struct_types> + ...) == 1)
+    [[nodiscard]] std::span<const T> column() const;
 
     /**
+     * @brief run an element kernel on columns of the soa
+     * @details the kernel is called on the elements of each structure in a plain indexed loop over the columns (which
+     * compilers can vectorize). The data of the columns is assumed aligned on the alignment of the column policy
+     * (`std::assume_aligned`).
+     * @tparam indexes of the columns given to the kernel
+     * @param kernel invocable with a reference on an element of each column (constant if the soa is)
+     */
+    template<std::size_t... indexes, typename Kernel>
+        requires(sizeof...(indexes) > 0)
+    void for_each_columns(Kernel&& kernel);
+    template<std::size_t... indexes, typename Kernel>
+        requires(sizeof...(indexes) > 0)
+    void for_each_columns(Kernel&& kernel) const;
+
+    /**
+     * @brief run a column kernel on columns of the soa: the kernel is called once with the spans of the columns
+     * @details the data of the columns is assumed aligned on the alignment of the column policy (`std::assume_aligned`).
+     * @tparam indexes of the columns given to the kernel
+     * @param kernel invocable with a span on each column (on constant elements if the soa is constant)
+     * @return result of the kernel
+     */
+    template<std::size_t... indexes, typename Kernel>
+        requires(sizeof...(indexes) > 0)
+    decltype(auto) with_columns(Kernel&& kernel);
+    template<std::size_t... indexes, typename Kernel>
+        requires(sizeof...(indexes) > 0)
+    decltype(auto) with_columns(Kernel&& kernel) const;
+
+    /**
+     * @details constant time: the generation of the id is checked against the one of its slot
      * @param id to check if the structure has
      * @return true if the structure of array contains the provided id
      */
@@ -204,17 +328,37 @@ class soa {
     [[nodiscard]] sentinel cend() const;
 
   private:
-    std::tuple<std::vector<struct_types>...> data_;
-    std::vector<struct_id> reverse_indexes_;
+    /**
+     * @return structure at the provided position of the columns
+     */
+    [[nodiscard]] soa_struct struct_at_(std::size_t position) { return {this, position}; }
+    [[nodiscard]] const_soa_struct struct_at_(std::size_t position) const { return {this, position}; }
+
+    /**
+     * @return data of a column (constant if the soa is), assumed aligned on the alignment of the column policy
+     */
+    template<std::size_t index, typename Self>
+    [[nodiscard]] static auto* aligned_data_(Self& self);
+
+    template<std::size_t... indexes, typename Self, typename Kernel>
+    static void for_each_columns_(Self& self, Kernel& kernel);
+
+    template<std::size_t... indexes, typename Self, typename Kernel>
+    static decltype(auto) with_columns_(Self& self, Kernel& kernel);
+
+  private:
+    std::tuple<std::vector<struct_types, typename column_policy::template allocator<struct_types>>...> data_;
+    std::vector<struct_id> reverse_indexes_; //!< id of the structure at each position of the data
+    //! slot of each id: position of its data and generation if used, next free slot and generation of its next use if free
     std::vector<struct_id> indexes_;
-    struct_id next_free_index_ {0, 0};
+    struct_id next_free_index_ {0, 0}; //!< first free slot, none if its offset is past the last slot
 };
 
-template<typename... struct_types>
+template<typename column_policy, typename... struct_types>
 template<typename T>
-class soa<struct_types...>::iterator_t {
-    friend class soa;
-    friend class soa_struct_t<soa>;
+class basic_soa<column_policy, struct_types...>::iterator_t {
+    friend class basic_soa;
+    friend class soa_struct_t<basic_soa>;
 
   public:
     using value_type      = soa_struct_t<T>;
@@ -224,8 +368,8 @@ class soa<struct_types...>::iterator_t {
 
     bool operator==(const iterator_t& t) const noexcept { return data_ == t.data_ && offset_ == t.offset_; }
     bool operator==(sentinel) const noexcept { return offset_ == data_->size(); }
-    value_type operator*() const noexcept { return (*data_)[data_->reverse_indexes_[offset_]]; }
-    value_type operator*() noexcept { return (*data_)[data_->reverse_indexes_[offset_]]; }
+    value_type operator*() const noexcept { return data_->struct_at_(offset_); }
+    value_type operator*() noexcept { return data_->struct_at_(offset_); }
 
     iterator_t& operator++() noexcept {
         ++offset_;
@@ -247,6 +391,18 @@ class soa<struct_types...>::iterator_t {
     size_t offset_ = 0;
 };
 
+/**
+ * @brief structure of arrays with columns allocated with the standard allocator
+ */
+template<typename... struct_types>
+using soa = basic_soa<default_columns, struct_types...>;
+
+/**
+ * @brief structure of arrays with columns aligned (and padded) on `alignment` bytes, for vectorized column kernels
+ */
+template<std::size_t alignment, typename... struct_types>
+using aligned_soa = basic_soa<aligned_columns<alignment>, struct_types...>;
+
 // ------------------------------------------------------------------------------------------------------------------------------------
 //
 // Implementation side of the soa class
@@ -255,8 +411,8 @@ class soa<struct_types...>::iterator_t {
 //
 //
 
-template<typename... struct_types>
-struct soa<struct_types...>::struct_id {
+template<typename column_policy, typename... struct_types>
+struct basic_soa<column_policy, struct_types...>::struct_id {
     struct_id next_generation() const noexcept;
 
     explicit constexpr struct_id(std::uint32_t i, std::uint8_t g = 0) noexcept;
@@ -267,8 +423,8 @@ struct soa<struct_types...>::struct_id {
     std::uint8_t generation;
 };
 
-template<typename... struct_types>
-constexpr soa<struct_types...>::struct_id::struct_id(std::uint32_t i, std::uint8_t g) noexcept
+template<typename column_policy, typename... struct_types>
+constexpr basic_soa<column_policy, struct_types...>::struct_id::struct_id(std::uint32_t i, std::uint8_t g) noexcept
     : offset(i)
     , generation(g) {}
 
@@ -277,9 +433,9 @@ typename T::struct_id soa_struct_t<T>::struct_id() const {
     return soa_->reverse_indexes_[offset_];
 }
 
-template<typename... struct_types>
+template<typename column_policy, typename... struct_types>
 template<typename... Us>
-soa<struct_types...>::struct_id soa<struct_types...>::insert(Us... us) {
+basic_soa<column_policy, struct_types...>::struct_id basic_soa<column_policy, struct_types...>::insert(Us... us) {
 
     std::invoke(
         [this]<std::size_t... Is, typename T>(std::index_sequence<Is...>, T to_insert) {
@@ -287,28 +443,31 @@ soa<struct_types...>::struct_id soa<struct_types...>::insert(Us... us) {
         },
         struct_number {}, std::forward_as_tuple(std::forward<Us>(us)...));
 
+    const auto position = static_cast<std::uint32_t>(reverse_indexes_.size());
     if (next_free_index_.offset >= indexes_.size()) {
-        indexes_.emplace_back(next_free_index_);
-        reverse_indexes_.emplace_back(next_free_index_);
-        next_free_index_ = struct_id {static_cast<std::uint32_t>(reverse_indexes_.size()), 0};
-        return indexes_.back();
+        // no free slot: a new slot is added
+        indexes_.emplace_back(position, 0);
+        reverse_indexes_.emplace_back(static_cast<std::uint32_t>(indexes_.size() - 1), 0);
+        next_free_index_ = struct_id {static_cast<std::uint32_t>(indexes_.size()), 0};
+        return reverse_indexes_.back();
     }
 
-    const auto inserted_index_offset = next_free_index_.offset;
-    reverse_indexes_.push_back(next_free_index_);
-    next_free_index_                       = indexes_[inserted_index_offset];
-    indexes_[inserted_index_offset].offset = reverse_indexes_.size() - 1;
-    return reverse_indexes_.back();
+    // the first free slot is used, with the generation it has been given when freed
+    const auto slot = next_free_index_.offset;
+    const struct_id id {slot, indexes_[slot].generation};
+    next_free_index_      = struct_id {indexes_[slot].offset, 0};
+    indexes_[slot].offset = position;
+    reverse_indexes_.push_back(id);
+    return id;
 }
 // soa definition
 //
-template<typename... struct_types>
-bool soa<struct_types...>::erase(struct_id id) {
+template<typename column_policy, typename... struct_types>
+bool basic_soa<column_policy, struct_types...>::erase(struct_id id) {
     if (!has_id(id))
         return false;
 
-    const auto id_removed  = id.offset;
-    const auto offset_data = reverse_indexes_[id_removed].offset;
+    const auto offset_data = indexes_[id.offset].offset;
 
     auto swap_all_data = [this, offset_data]<std::size_t... Is>(std::index_sequence<Is...>) {
         auto swap_one_vec = [this, offset_data]<typename T>(T& vec) { //
@@ -319,60 +478,154 @@ bool soa<struct_types...>::erase(struct_id id) {
     };
     std::invoke(swap_all_data, struct_number {});
 
-    // swap the last element with the one to be removed, and pop the last element
-    std::swap(reverse_indexes_[id_removed], reverse_indexes_.back());
-    indexes_[reverse_indexes_.back().offset]             = next_free_index_;
-    indexes_[reverse_indexes_[id_removed].offset].offset = id_removed;
-
-    reverse_indexes_.back().generation += 1; // increment generation of the next free index
-    next_free_index_ = reverse_indexes_.back();
+    // the last element is moved at the position of the removed one
+    reverse_indexes_[offset_data]                         = reverse_indexes_.back();
+    indexes_[reverse_indexes_[offset_data].offset].offset = offset_data;
     reverse_indexes_.pop_back();
 
+    // the slot is freed with an incremented generation (invalidating the id), and becomes the first free slot
+    indexes_[id.offset] = struct_id {next_free_index_.offset, static_cast<std::uint8_t>(id.generation + 1)};
+    next_free_index_    = struct_id {id.offset, 0};
+
     return true;
 }
-template<typename... struct_types>
-bool soa<struct_types...>::erase(const_iterator it) {
+template<typename column_policy, typename... struct_types>
+bool basic_soa<column_policy, struct_types...>::erase(const_iterator it) {
     return erase(*it);
 }
-template<typename... struct_types>
-void soa<struct_types...>::reserve(std::size_t size) {
+template<typename column_policy, typename... struct_types>
+void basic_soa<column_policy, struct_types...>::reserve(std::size_t size) {
     std::invoke([this, size]<std::size_t... Is>(std::index_sequence<Is...>) { (std::get<Is>(data_).reserve(size), ...); },
                 struct_number {});
 
     indexes_.reserve(size);
     reverse_indexes_.reserve(size);
-    next_free_index_ = struct_id {static_cast<std::uint32_t>(reverse_indexes_.size()), 0};
 }
-template<typename... struct_types>
-soa_struct_t<soa<struct_types...>> soa<struct_types...>::operator[](struct_id k) {
+template<typename column_policy, typename... struct_types>
+soa_struct_t<basic_soa<column_policy, struct_types...>> basic_soa<column_policy, struct_types...>::operator[](struct_id k) {
     return {this, indexes_[k.offset].offset};
 }
-template<typename... struct_types>
-typename soa<struct_types...>::const_soa_struct soa<struct_types...>::operator[](struct_id k) const {
+template<typename column_policy, typename... struct_types>
+auto basic_soa<column_policy, struct_types...>::operator[](struct_id k) const -> const_soa_struct {
     return {this, indexes_[k.offset].offset};
 }
-template<typename... struct_types>
-bool soa<struct_types...>::has_id(struct_id id) const {
-    return std::ranges::any_of(reverse_indexes_, [id](auto& i) { return i == id; });
+template<typename column_policy, typename... struct_types>
+std::optional<soa_struct_t<basic_soa<column_policy, struct_types...>>> basic_soa<column_policy, struct_types...>::at(struct_id k) {
+    if (!has_id(k)) {
+        return std::nullopt;
+    }
+    return soa_struct {this, indexes_[k.offset].offset};
 }
-template<typename... struct_types>
-typename soa<struct_types...>::iterator soa<struct_types...>::begin() {
+template<typename column_policy, typename... struct_types>
+auto basic_soa<column_policy, struct_types...>::at(struct_id k) const -> std::optional<const_soa_struct> {
+    if (!has_id(k)) {
+        return std::nullopt;
+    }
+    return const_soa_struct {this, indexes_[k.offset].offset};
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t index>
+auto basic_soa<column_policy, struct_types...>::column() -> std::span<struct_type_at<index>> {
+    return std::get<index>(data_);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t index>
+auto basic_soa<column_policy, struct_types...>::column() const -> std::span<const struct_type_at<index>> {
+    return std::get<index>(data_);
+}
+template<typename column_policy, typename... struct_types>
+template<typename T>
+    requires((std::is_same_v<T, struct_types> + ...) == 1)
+std::span<T> basic_soa<column_policy, struct_types...>::column() {
+    return std::get<parameter_pack_index<T, struct_types...>>(data_);
+}
+template<typename column_policy, typename... struct_types>
+template<typename T>
+    requires((std::is_same_v<T, struct_types> + ...) == 1)
+std::span<const T> basic_soa<column_policy, struct_types...>::column() const {
+    return std::get<parameter_pack_index<T, struct_types...>>(data_);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t... indexes, typename Kernel>
+    requires(sizeof...(indexes) > 0)
+void basic_soa<column_policy, struct_types...>::for_each_columns(Kernel&& kernel) {
+    for_each_columns_<indexes...>(*this, kernel);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t... indexes, typename Kernel>
+    requires(sizeof...(indexes) > 0)
+void basic_soa<column_policy, struct_types...>::for_each_columns(Kernel&& kernel) const {
+    for_each_columns_<indexes...>(*this, kernel);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t... indexes, typename Kernel>
+    requires(sizeof...(indexes) > 0)
+decltype(auto) basic_soa<column_policy, struct_types...>::with_columns(Kernel&& kernel) {
+    return with_columns_<indexes...>(*this, kernel);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t... indexes, typename Kernel>
+    requires(sizeof...(indexes) > 0)
+decltype(auto) basic_soa<column_policy, struct_types...>::with_columns(Kernel&& kernel) const {
+    return with_columns_<indexes...>(*this, kernel);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t index, typename Self>
+auto* basic_soa<column_policy, struct_types...>::aligned_data_(Self& self) {
+    auto* data = std::get<index>(self.data_).data();
+    if constexpr (column_policy::alignment != 0) {
+        return std::assume_aligned<column_policy::alignment>(data);
+    } else {
+        return data;
+    }
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t... indexes, typename Self, typename Kernel>
+void basic_soa<column_policy, struct_types...>::for_each_columns_(Self& self, Kernel& kernel) {
+    static_assert(std::invocable<Kernel&, decltype(*aligned_data_<indexes>(self))...>,
+                  "for_each_columns: the kernel must be invocable with an element of each column (with_columns for spans)");
+    const std::size_t count = self.size();
+    // plain loop on raw pointers: no indirection through the ids, nor bound checks, in the way of the vectorization
+    auto loop = [&kernel, count](auto*... columns) {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::invoke(kernel, columns[i]...);
+        }
+    };
+    loop(aligned_data_<indexes>(self)...);
+}
+template<typename column_policy, typename... struct_types>
+template<std::size_t... indexes, typename Self, typename Kernel>
+decltype(auto) basic_soa<column_policy, struct_types...>::with_columns_(Self& self, Kernel& kernel) {
+    const std::size_t count = self.size();
+    return std::invoke(kernel, std::span {aligned_data_<indexes>(self), count}...);
+}
+template<typename column_policy, typename... struct_types>
+bool basic_soa<column_policy, struct_types...>::has_id(struct_id id) const {
+    if (id.offset >= indexes_.size() || indexes_[id.offset].generation != id.generation) {
+        return false;
+    }
+    // the slot must refer back to the id: ids of a generation not given yet (on a free slot) are rejected as well
+    const auto position = indexes_[id.offset].offset;
+    return position < reverse_indexes_.size() && reverse_indexes_[position] == id;
+}
+template<typename column_policy, typename... struct_types>
+typename basic_soa<column_policy, struct_types...>::iterator basic_soa<column_policy, struct_types...>::begin() {
     return {this, 0};
 }
-template<typename... struct_types>
-typename soa<struct_types...>::const_iterator soa<struct_types...>::begin() const {
+template<typename column_policy, typename... struct_types>
+typename basic_soa<column_policy, struct_types...>::const_iterator basic_soa<column_policy, struct_types...>::begin() const {
     return {this, 0};
 }
-template<typename... struct_types>
-typename soa<struct_types...>::const_iterator soa<struct_types...>::cbegin() const {
+template<typename column_policy, typename... struct_types>
+typename basic_soa<column_policy, struct_types...>::const_iterator basic_soa<column_policy, struct_types...>::cbegin() const {
     return {this, 0};
 }
-template<typename... struct_types>
-typename soa<struct_types...>::sentinel soa<struct_types...>::end() const {
+template<typename column_policy, typename... struct_types>
+typename basic_soa<column_policy, struct_types...>::sentinel basic_soa<column_policy, struct_types...>::end() const {
     return {};
 }
-template<typename... struct_types>
-typename soa<struct_types...>::sentinel soa<struct_types...>::cend() const {
+template<typename column_policy, typename... struct_types>
+typename basic_soa<column_policy, struct_types...>::sentinel basic_soa<column_policy, struct_types...>::cend() const {
     return {};
 }
 
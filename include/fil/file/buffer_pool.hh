@@ -0,0 +1,221 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_BUFFER_POOL_HH
+#define FIL_BUFFER_POOL_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fil {
+
+static constexpr std::size_t BUFFER_POOL_ALIGNMENT  = 4096;             //!< alignment (and size granularity) of the pooled buffers
+static constexpr std::size_t BUFFER_POOL_MAX_CACHED = 64 * 1024 * 1024; //!< default maximum size of the free buffers kept by a pool (64Mb)
+
+class buffer_pool;
+
+/**
+ * @brief buffer borrowed from a @c buffer_pool, given back to the pool upon destruction (or @c reset)
+ */
+class pooled_buffer {
+    friend class buffer_pool;
+
+    pooled_buffer(char* data, std::size_t size, std::shared_ptr<buffer_pool> pool)
+        : data_(data)
+        , size_(size)
+        , pool_(std::move(pool)) {}
+
+  public:
+    pooled_buffer() = default;
+
+    pooled_buffer(pooled_buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , pool_(std::move(other.pool_)) {}
+
+    pooled_buffer& operator=(pooled_buffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            pool_ = std::move(other.pool_);
+        }
+        return *this;
+    }
+
+    pooled_buffer(const pooled_buffer&)            = delete;
+    pooled_buffer& operator=(const pooled_buffer&) = delete;
+
+    ~pooled_buffer() { reset(); }
+
+    /**
+     * @brief give the buffer back to its pool, the buffer is empty afterward
+     */
+    inline void reset();
+
+    [[nodiscard]] char* data() { return data_; }
+    [[nodiscard]] const char* data() const { return data_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return data_ == nullptr; }
+
+    char& operator[](std::size_t index) { return data_[index]; }
+    const char& operator[](std::size_t index) const { return data_[index]; }
+
+  private:
+    char* data_ {nullptr};              //!< aligned memory of the buffer
+    std::size_t size_ {0};              //!< size of the buffer (multiple of BUFFER_POOL_ALIGNMENT)
+    std::shared_ptr<buffer_pool> pool_; //!< pool the buffer is given back to
+};
+
+/**
+ * @brief Thread-safe pool of aligned buffers, shared by the readers to bound the memory to the buffers in use.
+ *
+ * @details The buffers are sized by multiple of BUFFER_POOL_ALIGNMENT: a buffer given back is kept in the free list of
+ * its size (as long as the free buffers kept don't exceed `max_cached_bytes`) to be borrowed again by the next reader
+ * requesting this size. A pool is always owned by a shared pointer (@c create), the borrowed buffers keeping it alive.
+ */
+class buffer_pool : public std::enable_shared_from_this<buffer_pool> {
+    struct private_tag {};
+
+  public:
+    explicit buffer_pool(private_tag, std::size_t max_cached_bytes)
+        : max_cached_bytes_(max_cached_bytes) {}
+
+    ~buffer_pool() { trim(); }
+
+    buffer_pool(const buffer_pool&)            = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    /**
+     * @param max_cached_bytes maximum size of the free buffers kept by the pool, the others being deallocated
+     * @return new pool of buffers
+     */
+    [[nodiscard]] static std::shared_ptr<buffer_pool> create(std::size_t max_cached_bytes = BUFFER_POOL_MAX_CACHED) {
+        return std::make_shared<buffer_pool>(private_tag {}, max_cached_bytes);
+    }
+
+    /**
+     * @return process-wide pool, used by the readers by default
+     */
+    [[nodiscard]] static const std::shared_ptr<buffer_pool>& global() {
+        static const std::shared_ptr<buffer_pool> pool = create();
+        return pool;
+    }
+
+    /**
+     * @param size minimum size of the buffer
+     * @return buffer of at least `size` bytes (rounded up to a multiple of BUFFER_POOL_ALIGNMENT), its content is
+     * unspecified
+     */
+    [[nodiscard]] pooled_buffer acquire(std::size_t size) {
+        size = std::max<std::size_t>((size + BUFFER_POOL_ALIGNMENT - 1) / BUFFER_POOL_ALIGNMENT, 1) * BUFFER_POOL_ALIGNMENT;
+        std::unique_lock lock(mutex_);
+        if (auto it = free_.find(size); it != free_.end() && !it->second.empty()) {
+            char* data = it->second.back();
+            it->second.pop_back();
+            cached_bytes_ -= size;
+            ++in_use_;
+            return {data, size, shared_from_this()};
+        }
+        lock.unlock();
+
+        auto* data = static_cast<char*>(::operator new[](size, std::align_val_t {BUFFER_POOL_ALIGNMENT}));
+        lock.lock();
+        ++in_use_;
+        return {data, size, shared_from_this()};
+    }
+
+    /**
+     * @brief deallocate the free buffers kept by the pool
+     */
+    void trim() {
+        std::scoped_lock lock(mutex_);
+        for (auto& [size, buffers] : free_) {
+            for (char* data : buffers) {
+                deallocate_(data);
+            }
+        }
+        free_.clear();
+        cached_bytes_ = 0;
+    }
+
+    /**
+     * @return number of buffers currently borrowed from the pool
+     */
+    [[nodiscard]] std::size_t in_use() const {
+        std::scoped_lock lock(mutex_);
+        return in_use_;
+    }
+
+    /**
+     * @return size of the free buffers kept by the pool
+     */
+    [[nodiscard]] std::size_t cached_bytes() const {
+        std::scoped_lock lock(mutex_);
+        return cached_bytes_;
+    }
+
+  private:
+    friend class pooled_buffer;
+
+    void give_back_(char* data, std::size_t size) {
+        {
+            std::scoped_lock lock(mutex_);
+            --in_use_;
+            if (cached_bytes_ + size <= max_cached_bytes_) {
+                free_[size].push_back(data);
+                cached_bytes_ += size;
+                return;
+            }
+        }
+        deallocate_(data);
+    }
+
+    static void deallocate_(char* data) { ::operator delete[](data, std::align_val_t {BUFFER_POOL_ALIGNMENT}); }
+
+  private:
+    mutable std::mutex mutex_;                                 //!< protects the state below
+    std::unordered_map<std::size_t, std::vector<char*>> free_; //!< free buffers per size
+    std::size_t max_cached_bytes_;                             //!< maximum size of the free buffers kept
+    std::size_t cached_bytes_ {0};                             //!< size of the free buffers kept
+    std::size_t in_use_ {0};                                   //!< number of buffers borrowed
+};
+
+inline void pooled_buffer::reset() {
+    if (data_ != nullptr) {
+        pool_->give_back_(data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    pool_.reset();
+}
+
+} // namespace fil
+
+#endif // FIL_BUFFER_POOL_HH
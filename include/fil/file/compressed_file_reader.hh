@@ -0,0 +1,659 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_COMPRESSED_FILE_READER_HH
+#define FIL_COMPRESSED_FILE_READER_HH
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "fil/algorithm/line_scan.hh"
+#include "fil/file/mapped_file.hh"
+#include "fil/meta/reader.hh"
+
+#if defined(FIL_WITH_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(FIL_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace fil {
+
+static constexpr std::size_t DECOMPRESSION_BLOCK_SIZE = 1024 * 1024; //!< size of the blocks decompressed at once (1Mb)
+
+/**
+ * @brief compression format of a file
+ */
+enum class compression {
+    none, //!< not compressed (or unknown format)
+    gzip, //!< gzip (or zlib) stream, possibly made of several members
+    zstd, //!< zstd stream, possibly made of several frames
+};
+
+/**
+ * @param header first bytes of the content
+ * @return compression format detected from the magic bytes of the content
+ */
+[[nodiscard]] constexpr compression detect_compression(std::string_view header) {
+    if (header.starts_with("\x1f\x8b")) {
+        return compression::gzip;
+    }
+    if (header.starts_with("\x28\xb5\x2f\xfd")) {
+        return compression::zstd;
+    }
+    return compression::none;
+}
+
+/**
+ * @brief options of the decompression of a @c compressed_file_reader
+ */
+struct decompression_options {
+    //! number of zstd frames decompressed in parallel (if more than 1). Only the frames of a known decompressed size up to
+    //! `memory_limit / threads` are decompressed in parallel, the others (and single frame files) are streamed
+    std::size_t threads = 1;
+    //! maximum memory held by the frames decompressed in parallel (in flight and being read)
+    std::size_t memory_limit = 64 * DECOMPRESSION_BLOCK_SIZE;
+};
+
+namespace details_ {
+
+/**
+ * @brief streaming decoder of a compressed content into blocks
+ */
+class decoder {
+  public:
+    virtual ~decoder() = default;
+
+    /**
+     * @param out buffer to decode into
+     * @param capacity maximum number of bytes to decode
+     * @return number of bytes decoded (less than capacity only at the end of the content), nullopt on error
+     */
+    virtual std::optional<std::size_t> decode(char* out, std::size_t capacity) = 0;
+};
+
+class raw_decoder final : public decoder {
+  public:
+    explicit raw_decoder(std::string_view content)
+        : content_(content) {}
+
+    std::optional<std::size_t> decode(char* out, std::size_t capacity) override {
+        const auto size = std::min(capacity, content_.size());
+        std::memcpy(out, content_.data(), size);
+        content_.remove_prefix(size);
+        return size;
+    }
+
+  private:
+    std::string_view content_; //!< content not decoded yet
+};
+
+#if defined(FIL_WITH_ZLIB)
+
+class gzip_decoder final : public decoder {
+    static constexpr std::size_t MAX_CHUNK = UINT_MAX; //!< zlib sizes are unsigned int
+
+  public:
+    explicit gzip_decoder(std::string_view content)
+        : content_(content) {
+        valid_ = ::inflateInit2(&stream_, 15 + 32) == Z_OK; // 15 + 32: zlib or gzip header detected automatically
+    }
+
+    ~gzip_decoder() override { ::inflateEnd(&stream_); }
+
+    gzip_decoder(const gzip_decoder&)            = delete;
+    gzip_decoder& operator=(const gzip_decoder&) = delete;
+
+    std::optional<std::size_t> decode(char* out, std::size_t capacity) override {
+        if (!valid_) {
+            return std::nullopt;
+        }
+        std::size_t produced = 0;
+        while (produced < capacity) {
+            if (stream_.avail_in == 0 && !content_.empty()) {
+                const auto chunk = std::min(content_.size(), MAX_CHUNK);
+                stream_.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(content_.data()));
+                stream_.avail_in = static_cast<uInt>(chunk);
+                content_.remove_prefix(chunk);
+            }
+            if (member_complete_) {
+                if (stream_.avail_in == 0) {
+                    break; // end of the content
+                }
+                // concatenated gzip members are decoded as a single content
+                if (::inflateReset(&stream_) != Z_OK) {
+                    valid_ = false;
+                    return std::nullopt;
+                }
+                member_complete_ = false;
+            }
+            const auto previous_input = stream_.avail_in;
+            const auto available      = static_cast<uInt>(std::min(capacity - produced, MAX_CHUNK));
+            stream_.next_out          = reinterpret_cast<Bytef*>(out + produced);
+            stream_.avail_out         = available;
+
+            const int result = ::inflate(&stream_, Z_NO_FLUSH);
+            produced += available - stream_.avail_out;
+            if (result == Z_STREAM_END) {
+                member_complete_ = true;
+            } else if ((result != Z_OK && result != Z_BUF_ERROR)
+                       || (stream_.avail_in == previous_input && stream_.avail_out == available)) {
+                valid_ = false; // corrupted or truncated member
+                return std::nullopt;
+            }
+        }
+        return produced;
+    }
+
+  private:
+    std::string_view content_;     //!< compressed content not given to zlib yet
+    z_stream stream_ {};           //!< inflate state
+    bool valid_ {false};           //!< false if the initialization or the decoding failed
+    bool member_complete_ {false}; //!< true if the end of the last gzip member decoded has been reached
+};
+
+#endif // FIL_WITH_ZLIB
+
+#if defined(FIL_WITH_ZSTD)
+
+class zstd_decoder final : public decoder {
+  public:
+    explicit zstd_decoder(std::string_view content)
+        : input_ {content.data(), content.size(), 0}
+        , context_(::ZSTD_createDCtx()) {}
+
+    ~zstd_decoder() override { ::ZSTD_freeDCtx(context_); }
+
+    zstd_decoder(const zstd_decoder&)            = delete;
+    zstd_decoder& operator=(const zstd_decoder&) = delete;
+
+    std::optional<std::size_t> decode(char* out, std::size_t capacity) override {
+        if (context_ == nullptr) {
+            return std::nullopt;
+        }
+        ZSTD_outBuffer output {out, capacity, 0};
+        while (output.pos < output.size) {
+            if (input_.pos == input_.size && pending_ == 0) {
+                break; // end of the content on a frame boundary
+            }
+            const auto previous_input = input_.pos;
+            const auto previous_out   = output.pos;
+            pending_                  = ::ZSTD_decompressStream(context_, &output, &input_);
+            if (::ZSTD_isError(pending_) || (input_.pos == previous_input && output.pos == previous_out)) {
+                return std::nullopt; // corrupted or truncated frame
+            }
+        }
+        return output.pos;
+    }
+
+  private:
+    ZSTD_inBuffer input_;     //!< compressed content, pos being the part already decoded
+    ZSTD_DCtx* context_;      //!< decompression state
+    std::size_t pending_ {0}; //!< 0 if the last frame decoded is complete and flushed
+};
+
+/**
+ * @brief zstd decoder decompressing the next frames of the content in parallel (zstd frames are independent)
+ *
+ * @details A frame is decompressed at once in memory: only the frames whose decompressed size is known and at most
+ * `memory_limit / threads` are decompressed in parallel, up to `threads` frames being held at once (in flight or being
+ * read) within `memory_limit`. The other frames are streamed block per block in the buffer of the reader, as by
+ * @c zstd_decoder, while the next frames are decompressed in parallel.
+ */
+class zstd_parallel_decoder final : public decoder {
+    /**
+     * @brief frame following the one being read, either decompressed in parallel or to be streamed
+     */
+    struct pending_frame {
+        std::future<std::optional<std::string>> decoded; //!< decompression of the frame, not valid if it is streamed
+        std::string_view compressed;                     //!< frame to stream
+    };
+
+  public:
+    zstd_parallel_decoder(std::string_view content, std::size_t threads, std::size_t memory_limit)
+        : content_(content)
+        , threads_(std::max<std::size_t>(threads, 1))
+        , memory_limit_(memory_limit) {}
+
+    /**
+     * @return true if the content is made of several frames (a single frame is better streamed)
+     */
+    [[nodiscard]] static bool has_several_frames(std::string_view content) {
+        const auto frame_size = ::ZSTD_findFrameCompressedSize(content.data(), content.size());
+        return !::ZSTD_isError(frame_size) && frame_size < content.size();
+    }
+
+    std::optional<std::size_t> decode(char* out, std::size_t capacity) override {
+        std::size_t produced = 0;
+        while (produced < capacity) {
+            if (streamed_ != nullptr) {
+                const auto size = streamed_->decode(out + produced, capacity - produced);
+                if (!size.has_value()) {
+                    return std::nullopt;
+                }
+                produced += size.value();
+                if (produced < capacity) {
+                    streamed_.reset(); // end of the streamed frame
+                }
+                continue;
+            }
+            if (frame_cursor_ == frame_.size()) {
+                held_ -= frame_.size();
+                frame_        = {};
+                frame_cursor_ = 0;
+                schedule_();
+                if (in_flight_.empty()) {
+                    break; // end of the content
+                }
+                auto next = std::move(in_flight_.front());
+                in_flight_.pop_front();
+                if (!next.decoded.valid()) {
+                    streamed_ = std::make_unique<zstd_decoder>(next.compressed);
+                } else if (auto frame = next.decoded.get(); frame.has_value()) {
+                    frame_ = std::move(frame.value());
+                } else {
+                    return std::nullopt;
+                }
+                schedule_();
+                continue;
+            }
+            const auto size = std::min(capacity - produced, frame_.size() - frame_cursor_);
+            std::memcpy(out + produced, frame_.data() + frame_cursor_, size);
+            frame_cursor_ += size;
+            produced += size;
+        }
+        return produced;
+    }
+
+  private:
+    /**
+     * @brief start the decompression of the next frames, up to `threads` frames held within the memory limit
+     */
+    void schedule_() {
+        while (!content_.empty() && in_flight_.size() + (frame_.empty() ? 0 : 1) < threads_) {
+            const auto frame_size = ::ZSTD_findFrameCompressedSize(content_.data(), content_.size());
+            if (::ZSTD_isError(frame_size)) {
+                auto corrupted = std::async(std::launch::deferred, [] { return std::optional<std::string> {}; });
+                in_flight_.push_back({.decoded = std::move(corrupted), .compressed = {}});
+                content_ = {};
+                return;
+            }
+            const auto frame        = content_.substr(0, frame_size);
+            const auto content_size = ::ZSTD_getFrameContentSize(frame.data(), frame.size());
+            if (content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR
+                || content_size > memory_limit_ / threads_) {
+                in_flight_.push_back({.decoded = {}, .compressed = frame});
+            } else if (held_ + content_size <= memory_limit_) {
+                held_ += content_size;
+                auto decoded = std::async(std::launch::async, &zstd_parallel_decoder::decode_frame_, frame, content_size);
+                in_flight_.push_back({.decoded = std::move(decoded), .compressed = {}});
+            } else {
+                return; // scheduled once the frames held are read
+            }
+            content_.remove_prefix(frame_size);
+        }
+    }
+
+    /**
+     * @param frame compressed
+     * @param content_size decompressed size of the frame
+     * @return frame decompressed, nullopt if corrupted
+     */
+    [[nodiscard]] static std::optional<std::string> decode_frame_(std::string_view frame, std::size_t content_size) {
+        std::string decoded(content_size, '\0');
+        const auto size = ::ZSTD_decompress(decoded.data(), decoded.size(), frame.data(), frame.size());
+        if (::ZSTD_isError(size) || size != decoded.size()) {
+            return std::nullopt;
+        }
+        return decoded;
+    }
+
+  private:
+    std::string_view content_;               //!< frames not scheduled yet
+    std::size_t threads_;                    //!< maximum number of frames decompressed in parallel
+    std::size_t memory_limit_;               //!< maximum size of the frames held (in flight and being read)
+    std::size_t held_ {0};                   //!< decompressed size of the frames held
+    std::deque<pending_frame> in_flight_;    //!< frames following the one being read, in order
+    std::string frame_;                      //!< frame currently read, if decompressed at once
+    std::size_t frame_cursor_ {0};           //!< part of the current frame already read
+    std::unique_ptr<zstd_decoder> streamed_; //!< frame currently read, if streamed
+};
+
+#endif // FIL_WITH_ZSTD
+
+} // namespace details_
+
+/**
+ * @brief Reader of a compressed file, decompressed block per block while being read.
+ *
+ * @details The compression format (gzip or zstd) is detected from the magic bytes of the file, a file that isn't
+ * compressed is read as is. The compressed file is memory mapped and decompressed in a buffer re-used for each block:
+ * there is no decompressed copy of the file on disk. The support of a format depends on the library it requires being
+ * available at compile time (`FIL_WITH_ZLIB` and `FIL_WITH_ZSTD`, see the `WITH_FIL_COMPRESSION` CMake option).
+ *
+ * As a decompression stream can only go forward, a load carries the part of the current block not read yet over in
+ * front of the next one (a line overlapping two blocks is contiguous in the buffer). Going back before the current
+ * block (@c read_line, @c restore to an older position) restarts the decompression from the beginning of the file.
+ *
+ * The zstd frames being independent, they can be decompressed in parallel (@c decompression_options::threads).
+ */
+class compressed_file_reader {
+  public:
+    using checkpoint_type = std::size_t; //!< a checkpoint of a compressed_file_reader is its position in the decompressed content
+
+    /**
+     * @brief block of text retrieved from the compressed_file_reader, valid until the next load of the reader
+     */
+    class block_view {
+        friend class compressed_file_reader;
+
+      private:
+        block_view(std::string_view block, std::size_t load_id_block, const compressed_file_reader* reader)
+            : block_(block)
+            , load_id_block_(load_id_block)
+            , reader_(reader) {}
+
+      public:
+        block_view() = default;
+
+        /**
+         * @return true if the block is still valid, false otherwise
+         */
+        [[nodiscard]] bool is_valid() const { return reader_ != nullptr && reader_->load_counter() == load_id_block_; }
+
+        /**
+         * @return string view representing the block read from the file
+         */
+        [[nodiscard]] std::string_view get() const { return is_valid() ? block_ : std::string_view {}; }
+
+      private:
+        std::string_view block_ {};                    //!< block retrieved from the buffer
+        std::size_t load_id_block_ {0};                //!< load id that contains that block of text
+        const compressed_file_reader* reader_ {};      //!< reader that contains the block
+    };
+
+    class sentinel {};   //!< sentinel for end iteration
+    class line_iterator; //!< iterator that iterate through lines in the file
+
+    explicit compressed_file_reader(std::filesystem::path file_path, decompression_options options = {})
+        : file_path_(std::move(file_path))
+        , options_(options)
+        , file_(std::make_unique<mapped_file>(file_path_)) {
+        file_->advise(access_advice::sequential);
+        compression_ = detect_compression(file_->view().substr(0, 4));
+        rewind_();
+    }
+
+    compressed_file_reader(compressed_file_reader&&)            = default;
+    compressed_file_reader& operator=(compressed_file_reader&&) = default;
+
+    [[nodiscard]] std::optional<std::uint8_t> next_byte() {
+        if (cursor_ >= buffer_size_) {
+            load_();
+        }
+        if (cursor_ >= buffer_size_) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(buffer_[cursor_++]);
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> previous_byte() {
+        if (cursor_ == 0 || cursor_ > buffer_size_) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(buffer_[--cursor_]);
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> peek() {
+        if (cursor_ >= buffer_size_) {
+            load_();
+        }
+        if (cursor_ >= buffer_size_) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(buffer_[cursor_]);
+    }
+
+    /**
+     * @brief read a specific line of the file, the decompression restarts from the beginning of the file
+     * @param line number of the line to read (starting at 1)
+     * @return block of the line (without the end of line character), invalid if the line doesn't exist
+     */
+    block_view read_line(std::size_t line) {
+        if (line == 0) {
+            return {};
+        }
+        rewind_();
+        for (std::size_t skipped = 1; skipped < line;) {
+            if (cursor_ >= buffer_size_) {
+                load_();
+                if (cursor_ >= buffer_size_) {
+                    return {};
+                }
+            }
+            const char* end     = buffer_.data() + buffer_size_;
+            const char* newline = find_newline(buffer_.data() + cursor_, end);
+            cursor_             = static_cast<std::size_t>(newline - buffer_.data()) + (newline != end ? 1 : 0);
+            skipped += newline != end ? 1 : 0;
+        }
+        return next_line();
+    }
+
+    /**
+     * @return next line of the file (without the end of line character), invalid if the end of the file is reached
+     */
+    [[nodiscard]] block_view next_line() {
+        if (cursor_ >= buffer_size_) {
+            load_();
+        }
+        if (cursor_ >= buffer_size_) {
+            cursor_ = std::numeric_limits<decltype(cursor_)>::max(); // force cursor at "end" for iterator
+            return {};
+        }
+        const char* newline = find_newline(buffer_.data() + cursor_, buffer_.data() + buffer_size_);
+        while (newline == buffer_.data() + buffer_size_ && !end_of_stream_) {
+            // the line continues in the next block: it is carried over in front of it
+            const auto line_offset = static_cast<std::size_t>(newline - buffer_.data()) - cursor_;
+            load_();
+            newline = find_newline(buffer_.data() + cursor_ + line_offset, buffer_.data() + buffer_size_);
+        }
+        const auto start = cursor_;
+        const auto end   = static_cast<std::size_t>(newline - buffer_.data());
+        cursor_          = std::min(end + 1, buffer_size_);
+        return {std::string_view(buffer_.data() + start, end - start), load_counter_, this};
+    }
+
+    /**
+     * @return checkpoint of the current state of the reader, @see restore
+     */
+    [[nodiscard]] checkpoint_type checkpoint() const { return reader_cursor(); }
+
+    /**
+     * @brief restore the reader at the state it had when the checkpoint was made
+     * @details if the position of the checkpoint is still in the buffer, only the cursor is restored. Otherwise the
+     * decompression restarts from the beginning of the file up to the position of the checkpoint.
+     */
+    void restore(checkpoint_type checkpoint) {
+        if (checkpoint < buffer_position_) {
+            rewind_();
+        }
+        while (checkpoint > buffer_position_ + buffer_size_ && !end_of_stream_) {
+            cursor_ = buffer_size_;
+            load_();
+        }
+        cursor_ = std::min(checkpoint - buffer_position_, buffer_size_);
+    }
+
+    /**
+     * @return true if the file has been opened and its compression format is supported
+     */
+    [[nodiscard]] bool is_open() const { return decoder_ != nullptr; }
+
+    /**
+     * @return true if the decompression failed (corrupted or truncated file)
+     */
+    [[nodiscard]] bool has_error() const { return error_; }
+
+    [[nodiscard]] compression compression_type() const { return compression_; }
+    [[nodiscard]] const std::filesystem::path& get_path() const { return file_path_; }
+    [[nodiscard]] bool exists() const { return std::filesystem::exists(file_path_); }
+    [[nodiscard]] std::size_t load_counter() const { return load_counter_; }
+
+    /**
+     * @return position of the reader in the decompressed content
+     */
+    [[nodiscard]] std::size_t reader_cursor() const { return buffer_position_ + std::min(cursor_, buffer_size_); }
+
+    [[nodiscard]] line_iterator make_line_iterator(std::size_t start = 1);
+    [[nodiscard]] sentinel end() { return {}; }
+
+  private:
+    /**
+     * @brief restart the decompression from the beginning of the file
+     */
+    void rewind_() {
+        decoder_         = make_decoder_();
+        buffer_size_     = 0;
+        buffer_position_ = 0;
+        cursor_          = 0;
+        end_of_stream_   = decoder_ == nullptr;
+        error_           = false;
+        ++load_counter_;
+    }
+
+    [[nodiscard]] std::unique_ptr<details_::decoder> make_decoder_() const {
+        if (!file_->is_open()) {
+            return nullptr;
+        }
+        const auto content = file_->view();
+        switch (compression_) {
+            case compression::none: return std::make_unique<details_::raw_decoder>(content);
+#if defined(FIL_WITH_ZLIB)
+            case compression::gzip: return std::make_unique<details_::gzip_decoder>(content);
+#endif
+#if defined(FIL_WITH_ZSTD)
+            case compression::zstd:
+                if (options_.threads > 1 && details_::zstd_parallel_decoder::has_several_frames(content)) {
+                    return std::make_unique<details_::zstd_parallel_decoder>(content, options_.threads, options_.memory_limit);
+                }
+                return std::make_unique<details_::zstd_decoder>(content);
+#endif
+            default: return nullptr;
+        }
+    }
+
+    /**
+     * @brief decompress the next block into the buffer, after the part of the current block not read yet
+     */
+    void load_() {
+        if (end_of_stream_) {
+            return;
+        }
+        const auto consumed   = std::min(cursor_, buffer_size_);
+        const auto carry_over = buffer_size_ - consumed;
+        std::memmove(buffer_.data(), buffer_.data() + consumed, carry_over);
+        if (buffer_.size() < carry_over + DECOMPRESSION_BLOCK_SIZE) {
+            buffer_.resize(carry_over + DECOMPRESSION_BLOCK_SIZE);
+        }
+        ++load_counter_;
+
+        const auto decoded = decoder_->decode(buffer_.data() + carry_over, DECOMPRESSION_BLOCK_SIZE);
+        error_             = !decoded.has_value();
+        end_of_stream_     = decoded.value_or(0) < DECOMPRESSION_BLOCK_SIZE;
+        buffer_position_ += consumed;
+        buffer_size_ = carry_over + decoded.value_or(0);
+        cursor_      = 0;
+    }
+
+  private:
+    std::filesystem::path file_path_;           //!< path of the compressed file
+    decompression_options options_;             //!< options of the decompression
+    std::unique_ptr<mapped_file> file_;         //!< mapping of the compressed file
+    compression compression_ {compression::none}; //!< compression format of the file
+    std::unique_ptr<details_::decoder> decoder_; //!< decompression stream, null if the format isn't supported
+
+    std::string buffer_;               //!< decompressed data: carried over data followed by the last block decompressed
+    std::size_t buffer_size_ {0};      //!< size of the decompressed data in the buffer
+    std::size_t buffer_position_ {0};  //!< position in the decompressed content of the beginning of the buffer
+    std::size_t cursor_ {0};           //!< cursor in the buffer
+    std::size_t load_counter_ {0};     //!< counter to inform on how many load occurred
+    bool end_of_stream_ {false};       //!< true once the whole content has been decompressed
+    bool error_ {false};               //!< true if the decompression failed
+};
+
+/**
+ * @brief iterator through the lines of a compressed_file_reader
+ */
+class compressed_file_reader::line_iterator {
+  public:
+    explicit line_iterator(compressed_file_reader* reader, std::size_t start_line = 1)
+        : reader_(reader)
+        , line_(reader->read_line(start_line))
+        , line_number_(start_line) {}
+
+    [[nodiscard]] std::size_t line() const { return line_number_; }
+
+    const block_view& operator*() const { return line_; }
+    const block_view* operator->() const { return &line_; }
+
+    line_iterator& operator++() {
+        if (*this == compressed_file_reader::sentinel {}) {
+            return *this;
+        }
+        line_ = reader_->next_line();
+        ++line_number_;
+        return *this;
+    }
+
+    bool operator==(compressed_file_reader::sentinel) const { return !line_.is_valid(); }
+    bool operator!=(compressed_file_reader::sentinel s) const { return !(operator==(s)); }
+
+  private:
+    compressed_file_reader* reader_;
+    block_view line_ {};
+    std::size_t line_number_ {0};
+};
+
+[[nodiscard]] inline compressed_file_reader::line_iterator compressed_file_reader::make_line_iterator(std::size_t start) {
+    return compressed_file_reader::line_iterator(this, start);
+}
+
+static_assert(meta::bytes_reader<compressed_file_reader>, "compressed_file_reader must be a byte reader");
+static_assert(meta::line_reader<compressed_file_reader>, "compressed_file_reader must be a line reader");
+static_assert(meta::checkpoint_reader<compressed_file_reader>, "compressed_file_reader must be a checkpoint reader");
+
+} // namespace fil
+
+#endif // FIL_COMPRESSED_FILE_READER_HH
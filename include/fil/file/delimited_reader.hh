@@ -0,0 +1,236 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_DELIMITED_READER_HH
+#define FIL_DELIMITED_READER_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fil/algorithm/delimited_scan.hh"
+#include "fil/algorithm/line_scan.hh"
+#include "fil/file/mapped_file.hh"
+#include "fil/file/parallel_lines.hh"
+
+namespace fil {
+
+/**
+ * @brief fields of a record of a delimited file, views on the file valid until the next record is read
+ */
+class delimited_record {
+  public:
+    delimited_record() = default;
+    explicit delimited_record(std::span<const std::string_view> fields)
+        : fields_(fields)
+        , valid_(true) {}
+
+    /**
+     * @return true if the record has been read, false at the end of the file
+     */
+    [[nodiscard]] bool is_valid() const { return valid_; }
+
+    [[nodiscard]] std::size_t size() const { return fields_.size(); }
+    [[nodiscard]] std::string_view operator[](std::size_t index) const { return fields_[index]; }
+    [[nodiscard]] std::span<const std::string_view> fields() const { return fields_; }
+
+    [[nodiscard]] auto begin() const { return fields_.begin(); }
+    [[nodiscard]] auto end() const { return fields_.end(); }
+
+  private:
+    std::span<const std::string_view> fields_ {}; //!< fields of the record (enclosing quotes removed)
+    bool valid_ {false};                          //!< false if no record has been read
+};
+
+/**
+ * @brief Reader of the records of a delimited file (CSV, TSV...), producing views on the fields without allocation.
+ *
+ * @details The file is memory mapped and scanned with @c delimited_scanner: quoted fields (containing delimiters, ends
+ * of line or doubled quotes) and CRLF ends of line are supported. The fields are views on the mapping: the enclosing
+ * quotes are removed, the doubled quotes are kept (@see unescape_field).
+ */
+class delimited_reader {
+  public:
+    explicit delimited_reader(const std::filesystem::path& file_path, csv_dialect dialect = {})
+        : file_(file_path)
+        , scanner_(file_.view(), dialect) {
+        file_.advise(access_advice::sequential);
+    }
+
+    delimited_reader(const delimited_reader&)            = delete;
+    delimited_reader& operator=(const delimited_reader&) = delete;
+
+    /**
+     * @return next record of the file, invalid if the end of the file is reached
+     */
+    [[nodiscard]] delimited_record next_record() {
+        if (!scanner_.next(fields_)) {
+            return {};
+        }
+        return delimited_record(fields_);
+    }
+
+    /**
+     * @return true if the file has been opened successfully
+     */
+    [[nodiscard]] bool is_open() const { return file_.is_open(); }
+
+    /**
+     * @return position in the file of the beginning of the next record
+     */
+    [[nodiscard]] std::size_t reader_cursor() const { return scanner_.position(); }
+
+  private:
+    mapped_file file_;                     //!< mapping of the file
+    delimited_scanner scanner_;            //!< scanner of the records of the mapping
+    std::vector<std::string_view> fields_; //!< fields of the last record (re-used from a record to another)
+};
+
+/**
+ * @brief split a delimited content into chunks of about `chunk_size` bytes, each chunk (except the first one) starting
+ * right after an end of line that isn't part of a quoted field
+ *
+ * @details The quotes of each chunk of `chunk_size` bytes are counted in parallel; the parity of the quotes preceding a
+ * chunk tells if it begins inside a quoted field, from where the first end of record is searched.
+ *
+ * @param content to split
+ * @param dialect characters of the format
+ * @param executor executor running the count of the quotes of each chunk
+ * @param chunk_size targeted size of a chunk, a chunk can be bigger if its last record overlaps the next chunk
+ * @return offsets of the beginning of each chunk, followed by the size of the content (the end of the last chunk)
+ */
+template<chunk_executor Executor = thread_executor>
+[[nodiscard]] std::vector<std::size_t> split_on_records(std::string_view content, csv_dialect dialect = {}, Executor&& executor = {},
+                                                        std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    chunk_size          = std::max<std::size_t>(chunk_size, 1);
+    const auto segments = (content.size() + chunk_size - 1) / chunk_size;
+
+    std::vector<std::size_t> quotes(segments);
+    executor(segments, [&](std::size_t index) {
+        const char* first = content.data() + index * chunk_size;
+        const char* last  = content.data() + std::min(content.size(), (index + 1) * chunk_size);
+        quotes[index]     = count_byte(first, last, dialect.quote);
+    });
+
+    std::vector<std::size_t> bounds {0};
+    std::size_t preceding_quotes = 0;
+    for (std::size_t index = 1; index < segments; ++index) {
+        preceding_quotes += quotes[index - 1];
+        auto position = index * chunk_size;
+        if (position < bounds.back()) {
+            continue; // the previous record overlaps this segment
+        }
+        // search the first end of line outside of a quoted field
+        bool quoted = preceding_quotes % 2 == 1;
+        for (; position < content.size() && (quoted || content[position] != '\n'); ++position) {
+            quoted ^= content[position] == dialect.quote;
+        }
+        if (position >= content.size()) {
+            break;
+        }
+        bounds.push_back(position + 1);
+    }
+    if (bounds.back() != content.size()) {
+        bounds.push_back(content.size());
+    }
+    return bounds;
+}
+
+/**
+ * @brief reduce the records of a delimited file in parallel: each chunk of records is reduced independently from `init`,
+ * then the results of the chunks are combined in the order of the file
+ * @param path of the file to process
+ * @param init initial value of the reduction of each chunk (and of the combination of the chunks)
+ * @param accumulate function called as `accumulate(T& accumulator, const delimited_record& record)` on each record
+ * @param combine function called as `combine(T accumulated, T chunk_result) -> T` in the order of the chunks
+ * @param dialect characters of the format
+ * @param executor executor running the processing of the chunks, a pool of `hardware_concurrency` threads by default
+ * @param chunk_size targeted size of the chunks of records processed by a worker at once
+ * @return combination of the results of all the chunks
+ * @throw std::runtime_error if the file cannot be mapped
+ */
+template<typename T, typename Accumulate, typename Combine, chunk_executor Executor = thread_executor>
+requires std::invocable<Accumulate&, T&, const delimited_record&> && std::is_invocable_r_v<T, Combine&, T, T>
+[[nodiscard]] T parallel_reduce_records(const std::filesystem::path& path, T init, Accumulate&& accumulate, Combine&& combine,
+                                        csv_dialect dialect = {}, Executor&& executor = {},
+                                        std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    const mapped_file file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Could not open file for reading: {}", path.string()));
+    }
+    file.advise(access_advice::sequential);
+
+    const auto content = file.view();
+    const auto bounds  = split_on_records(content, dialect, executor, chunk_size);
+    const auto chunks  = bounds.size() - 1;
+
+    std::vector<std::optional<T>> results(chunks);
+    executor(chunks, [&](std::size_t index) {
+        T accumulator = init;
+        delimited_scanner scanner(content.substr(bounds[index], bounds[index + 1] - bounds[index]), dialect);
+        std::vector<std::string_view> fields;
+        while (scanner.next(fields)) {
+            std::invoke(accumulate, accumulator, delimited_record(fields));
+        }
+        results[index].emplace(std::move(accumulator));
+    });
+
+    T accumulated = std::move(init);
+    for (auto& chunk_result : results) {
+        accumulated = std::invoke(combine, std::move(accumulated), std::move(chunk_result.value()));
+    }
+    return accumulated;
+}
+
+/**
+ * @brief call a function on each record of a delimited file, the records being processed in parallel (in no particular
+ * order)
+ * @param path of the file to process
+ * @param fn thread-safe function called on each record
+ * @param dialect characters of the format
+ * @param executor executor running the processing of the chunks, a pool of `hardware_concurrency` threads by default
+ * @param chunk_size targeted size of the chunks of records processed by a worker at once
+ * @throw std::runtime_error if the file cannot be mapped
+ */
+template<std::invocable<const delimited_record&> Fn, chunk_executor Executor = thread_executor>
+void parallel_for_each_record(const std::filesystem::path& path, Fn&& fn, csv_dialect dialect = {}, Executor&& executor = {},
+                              std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    struct nothing {};
+    std::ignore = parallel_reduce_records(
+        path, nothing {}, [&fn](nothing&, const delimited_record& record) { std::invoke(fn, record); },
+        [](nothing, nothing) { return nothing {}; }, dialect, std::forward<Executor>(executor), chunk_size);
+}
+
+} // namespace fil
+
+#endif // FIL_DELIMITED_READER_HH
@@ -0,0 +1,349 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_FILE_FOLLOWER_HH
+#define FIL_FILE_FOLLOWER_HH
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __has_include(<sys/inotify.h>)
+#include <sys/inotify.h>
+#define FIL_FOLLOWER_INOTIFY 1
+#endif
+
+#include "fil/algorithm/line_scan.hh"
+#include "fil/file/file_handle.hh"
+
+namespace fil {
+
+static constexpr std::size_t FOLLOWER_READ_SIZE = 64 * 1024; //!< size of the reads of the new data of a followed file (64Kb)
+
+/**
+ * @brief options of a @c file_follower
+ */
+struct follow_options {
+    bool from_beginning = false;                    //!< read the existing content of the file first, otherwise start at its end
+    std::chrono::milliseconds poll_interval {250}; //!< maximum time in between two checks of the file while waiting
+};
+
+/**
+ * @brief Reader of the lines appended to a file (`tail -F`), for growing log files.
+ *
+ * @details Only the new bytes of the file are read (positional reads from the last position read), into a buffer in
+ * which the incomplete last line is kept until its end of line is appended. While waiting for new lines, the changes of
+ * the directory of the file are watched with inotify (when available) with a periodic check of the file as a fallback
+ * (and as the only mechanism if inotify isn't available, e.g. on network filesystems where it doesn't report changes).
+ *
+ * - A file truncated below the position read (`copytruncate` rotation) is read again from its beginning.
+ * - A file replaced by a new file at the same path (`rename` + `create` rotation) is read until its end, then the new
+ *   file is followed from its beginning. The incomplete last line of the old file is returned as a line.
+ *
+ * Positions are 64 bits: files bigger than 4Gb are followed.
+ */
+class file_follower {
+  public:
+    /**
+     * @brief line retrieved from the file_follower, valid until the next load of new data from the file
+     */
+    class block_view {
+        friend class file_follower;
+
+      private:
+        block_view(std::string_view block, std::size_t load_id_block, const file_follower* follower)
+            : block_(block)
+            , load_id_block_(load_id_block)
+            , follower_(follower) {}
+
+      public:
+        block_view() = default;
+
+        /**
+         * @return true if the line is still valid, false otherwise
+         */
+        [[nodiscard]] bool is_valid() const { return follower_ != nullptr && follower_->load_counter() == load_id_block_; }
+
+        /**
+         * @return string view representing the line read from the file
+         */
+        [[nodiscard]] std::string_view get() const { return is_valid() ? block_ : std::string_view {}; }
+
+      private:
+        std::string_view block_ {};         //!< line retrieved from the buffer
+        std::size_t load_id_block_ {0};     //!< load id that contains that line
+        const file_follower* follower_ {}; //!< follower that contains the line
+    };
+
+    explicit file_follower(std::filesystem::path file_path, follow_options options = {})
+        : file_path_(std::move(file_path))
+        , options_(options) {
+        open_();
+        if (!options_.from_beginning && file_ != nullptr) {
+            file_position_ = file_->size();
+        }
+#if defined(FIL_FOLLOWER_INOTIFY)
+        notify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notify_fd_ >= 0) {
+            // the directory is watched (instead of the file) to be notified of the creation of a new file at the path
+            const auto directory = file_path_.has_parent_path() ? file_path_.parent_path() : std::filesystem::path(".");
+            if (::inotify_add_watch(notify_fd_, directory.c_str(), IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_DELETE) < 0) {
+                ::close(notify_fd_);
+                notify_fd_ = -1;
+            }
+        }
+#endif
+    }
+
+    ~file_follower() {
+        if (notify_fd_ >= 0) {
+            ::close(notify_fd_);
+        }
+    }
+
+    file_follower(const file_follower&)            = delete;
+    file_follower& operator=(const file_follower&) = delete;
+
+    /**
+     * @brief retrieve the next complete line of the file without waiting
+     * @return next line (without the end of line character), invalid if no complete line is available yet
+     */
+    [[nodiscard]] block_view try_next_line() {
+        while (true) {
+            if (auto line = next_buffered_line_(); line.is_valid()) {
+                return line;
+            }
+            if (!load_()) {
+                return {};
+            }
+        }
+    }
+
+    /**
+     * @brief wait for the next complete line of the file
+     * @param timeout maximum time to wait for a line
+     * @return next line (without the end of line character), invalid if no line has been appended before the timeout
+     */
+    [[nodiscard]] block_view next_line(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            if (auto line = try_next_line(); line.is_valid()) {
+                return line;
+            }
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                return {};
+            }
+            wait_(std::min(remaining, options_.poll_interval));
+        }
+    }
+
+    /**
+     * @brief wait for the next complete line of the file
+     * @param stop token stopping the wait, checked at least every `poll_interval`
+     * @return next line (without the end of line character), invalid if a stop has been requested
+     */
+    [[nodiscard]] block_view next_line(std::stop_token stop) {
+        while (!stop.stop_requested()) {
+            if (auto line = try_next_line(); line.is_valid()) {
+                return line;
+            }
+            wait_(options_.poll_interval);
+        }
+        return {};
+    }
+
+    /**
+     * @brief call a function on each line of the file as soon as it is appended, until a stop is requested
+     * @param stop token stopping the follow, checked at least every `poll_interval`
+     * @param on_line function called on each line (without its end of line character)
+     */
+    template<std::invocable<std::string_view> Fn>
+    void follow(std::stop_token stop, Fn&& on_line) {
+        while (!stop.stop_requested()) {
+            if (const auto line = next_line(stop); line.is_valid()) {
+                std::invoke(on_line, line.get());
+            }
+        }
+    }
+
+    /**
+     * @return true if the followed file is currently opened (it can be created after the follower)
+     */
+    [[nodiscard]] bool is_open() const { return file_ != nullptr; }
+
+    /**
+     * @return true if the changes of the file are notified by inotify, false if the follower only polls the file
+     */
+    [[nodiscard]] bool is_notified() const { return notify_fd_ >= 0; }
+
+    /**
+     * @return position in the followed file of the next byte to read
+     */
+    [[nodiscard]] std::size_t file_position() const { return file_position_; }
+
+    /**
+     * @return number of times the file has been rotated (replaced or truncated) since the follower has been created
+     */
+    [[nodiscard]] std::size_t rotation_count() const { return rotation_count_; }
+
+    [[nodiscard]] const std::filesystem::path& get_path() const { return file_path_; }
+    [[nodiscard]] std::size_t load_counter() const { return load_counter_; }
+
+  private:
+    /**
+     * @brief open the file at the path and retrieve its identity (a rotation replaces the file at the path)
+     */
+    void open_() {
+        auto file = std::make_unique<file_handle>(file_path_);
+        struct stat file_stat {};
+        if (!file->is_open() || ::fstat(file->descriptor(), &file_stat) != 0) {
+            file_.reset();
+            return;
+        }
+        file_   = std::move(file);
+        device_ = file_stat.st_dev;
+        inode_  = file_stat.st_ino;
+    }
+
+    /**
+     * @return true if the path now designates another file than the one followed
+     */
+    [[nodiscard]] bool is_replaced_() const {
+        struct stat path_stat {};
+        if (::stat(file_path_.c_str(), &path_stat) != 0) {
+            return false; // moved without being re-created yet: the old file is still followed
+        }
+        return file_ == nullptr || path_stat.st_dev != device_ || path_stat.st_ino != inode_;
+    }
+
+    [[nodiscard]] block_view next_buffered_line_() {
+        const char* end     = buffer_.data() + buffer_.size();
+        const char* newline = find_newline(buffer_.data() + scanned_, end);
+        if (newline == end) {
+            scanned_ = buffer_.size(); // the incomplete line isn't scanned again on the next call
+            return {};
+        }
+        const auto start = cursor_;
+        const auto size  = static_cast<std::size_t>(newline - buffer_.data()) - start;
+        cursor_          = start + size + 1;
+        scanned_         = cursor_;
+        return {std::string_view(buffer_.data() + start, size), load_counter_, this};
+    }
+
+    /**
+     * @brief append the next chunk of new data of the file after the incomplete line of the buffer, following a rotation
+     * if the file has been truncated or replaced
+     * @details a single chunk is read per load: a follower behind the end of the file (or reading it from its beginning)
+     * doesn't buffer the whole backlog, the buffer holds at most the incomplete line and a chunk.
+     * @return true if data has been appended to the buffer
+     */
+    bool load_() {
+        buffer_.erase(0, cursor_);
+        scanned_ -= cursor_;
+        cursor_ = 0;
+        ++load_counter_;
+
+        if (file_ != nullptr && file_->size() < file_position_) {
+            // truncated: the content before the truncation is lost, the new content is read from the beginning
+            buffer_.clear();
+            scanned_       = 0;
+            file_position_ = 0;
+            ++rotation_count_;
+        }
+        if (const auto read = read_new_data_(); read != 0 || !is_replaced_()) {
+            return read != 0;
+        }
+        // the old file has been read until its end: its last line is complete
+        const bool completed = !buffer_.empty();
+        if (completed) {
+            buffer_.push_back('\n');
+        }
+        const bool was_open = file_ != nullptr;
+        open_();
+        file_position_ = 0;
+        rotation_count_ += was_open ? 1 : 0;
+        return read_new_data_() != 0 || completed;
+    }
+
+    /**
+     * @return number of bytes read from the current position (at most FOLLOWER_READ_SIZE)
+     */
+    std::size_t read_new_data_() {
+        if (file_ == nullptr) {
+            return 0;
+        }
+        const auto previous_size = buffer_.size();
+        buffer_.resize(previous_size + FOLLOWER_READ_SIZE);
+        const auto read = file_->read_at(buffer_.data() + previous_size, FOLLOWER_READ_SIZE, file_position_).value_or(0);
+        buffer_.resize(previous_size + read);
+        file_position_ += read;
+        return read;
+    }
+
+    /**
+     * @brief wait for a change in the directory of the file (or for the timeout if inotify isn't available)
+     */
+    void wait_(std::chrono::milliseconds timeout) const {
+        if (notify_fd_ < 0) {
+            std::this_thread::sleep_for(timeout);
+            return;
+        }
+        pollfd descriptor {.fd = notify_fd_, .events = POLLIN, .revents = 0};
+        if (::poll(&descriptor, 1, static_cast<int>(timeout.count())) > 0) {
+            // the events are only a wake up signal: the file is checked anyway
+            alignas(8) char events[4096];
+            while (::read(notify_fd_, events, sizeof(events)) > 0) {}
+        }
+    }
+
+  private:
+    std::filesystem::path file_path_;   //!< path of the followed file
+    follow_options options_;            //!< options of the follower
+    std::unique_ptr<file_handle> file_; //!< file currently followed, null if there is no file at the path
+    dev_t device_ {};                   //!< device of the file currently followed
+    ino_t inode_ {};                    //!< inode of the file currently followed
+    int notify_fd_ {-1};                //!< inotify descriptor, negative if the file is only polled
+
+    std::string buffer_;               //!< data read from the file and not returned yet (incomplete line at the end)
+    std::size_t cursor_ {0};           //!< beginning of the next line in the buffer
+    std::size_t scanned_ {0};          //!< part of the buffer already searched for an end of line
+    std::size_t file_position_ {0};    //!< position in the file of the next byte to read
+    std::size_t load_counter_ {0};     //!< counter to inform on how many load occurred
+    std::size_t rotation_count_ {0};   //!< number of rotations (truncation or replacement) of the file
+};
+
+} // namespace fil
+
+#endif // FIL_FILE_FOLLOWER_HH
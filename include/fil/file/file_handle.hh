@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_FILE_HANDLE_HH
+#define FIL_FILE_HANDLE_HH
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <optional>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fil {
+
+static constexpr std::size_t DIRECT_IO_ALIGNMENT = 4096; //!< alignment of the buffers, offsets and sizes of the direct reads
+
+/**
+ * @brief usage of the page cache by the reads of a @c file_handle
+ */
+enum class cache_mode {
+    keep,   //!< the pages read stay in the page cache
+    drop,   //!< the pages read are dropped from the page cache after each read (`posix_fadvise(DONTNEED)`)
+    direct, //!< the reads bypass the page cache (`O_DIRECT`), `drop` if the filesystem doesn't support it (tmpfs...)
+};
+
+/**
+ * @brief Read-only file descriptor reading with positional reads (`pread`).
+ *
+ * @details A positional read doesn't depend on (nor modify) a cursor of the file descriptor: the same handle can be
+ * shared by several readers (and threads), each one keeping its own position in the file. The descriptor is closed
+ * upon destruction of the handle.
+ *
+ * In direct mode, a read whose buffer, offset and size are aligned on DIRECT_IO_ALIGNMENT is done in place, the others
+ * go through an aligned bounce buffer: any read is valid, the aligned ones being copy-free.
+ */
+class file_handle {
+  public:
+    explicit file_handle(const std::filesystem::path& path, cache_mode mode = cache_mode::keep)
+        : mode_(mode) {
+        if (mode_ == cache_mode::direct) {
+            fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        }
+        if (fd_ < 0) {
+            fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (mode_ == cache_mode::direct) {
+                mode_ = cache_mode::drop;
+            }
+        }
+    }
+
+    ~file_handle() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    file_handle(const file_handle&)            = delete;
+    file_handle& operator=(const file_handle&) = delete;
+
+    /**
+     * @return true if the file has been opened successfully
+     */
+    [[nodiscard]] bool is_open() const { return fd_ >= 0; }
+
+    /**
+     * @return file descriptor of the handle, negative if the file couldn't be opened
+     */
+    [[nodiscard]] int descriptor() const { return fd_; }
+
+    /**
+     * @return usage of the page cache by the reads (`drop` for a direct handle on a filesystem not supporting it)
+     */
+    [[nodiscard]] cache_mode mode() const { return mode_; }
+
+    /**
+     * @return true if the reads bypass the page cache
+     */
+    [[nodiscard]] bool is_direct() const { return mode_ == cache_mode::direct; }
+
+    /**
+     * @return current size of the file in bytes, 0 if the file isn't open
+     */
+    [[nodiscard]] std::size_t size() const {
+        struct stat file_stat {};
+        if (fd_ < 0 || ::fstat(fd_, &file_stat) != 0) {
+            return 0;
+        }
+        return static_cast<std::size_t>(file_stat.st_size);
+    }
+
+    /**
+     * @brief read a range of the file, independently of any other read on the handle
+     * @param buffer to read into, of at least `size` bytes
+     * @param size number of bytes to read
+     * @param offset position in the file of the beginning of the range
+     * @return number of bytes read (less than `size` only if the end of the file is reached), nullopt on error
+     */
+    [[nodiscard]] std::optional<std::size_t> read_at(char* buffer, std::size_t size, std::size_t offset) const {
+        if (fd_ < 0) {
+            return std::nullopt;
+        }
+        if (mode_ == cache_mode::direct && !is_aligned_(reinterpret_cast<std::uintptr_t>(buffer) | size | offset)) {
+            return read_bounced_(buffer, size, offset);
+        }
+        const auto read = pread_(buffer, size, offset);
+        if (read.has_value() && mode_ == cache_mode::drop) {
+            // the partial page in front of the range has been read by the previous read of a sequential reading
+            const auto begin = offset / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+            ::posix_fadvise(fd_, static_cast<off_t>(begin), static_cast<off_t>(offset + *read - begin), POSIX_FADV_DONTNEED);
+        }
+        return read;
+    }
+
+  private:
+    struct aligned_deleter {
+        void operator()(char* buffer) const { ::operator delete[](buffer, std::align_val_t {DIRECT_IO_ALIGNMENT}); }
+    };
+
+    std::optional<std::size_t> pread_(char* buffer, std::size_t size, std::size_t offset) const {
+        std::size_t read = 0;
+        while (read < size) {
+            const auto result = ::pread(fd_, buffer + read, size - read, static_cast<off_t>(offset + read));
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return std::nullopt;
+            }
+            if (result == 0) {
+                break; // end of the file
+            }
+            read += static_cast<std::size_t>(result);
+            if (mode_ == cache_mode::direct && !is_aligned_(read)) {
+                break; // end of the file: a direct read at the unaligned offset following it would be rejected
+            }
+        }
+        return read;
+    }
+
+    /**
+     * @brief direct read of an unaligned range: the aligned range containing it is read in a temporary buffer
+     */
+    std::optional<std::size_t> read_bounced_(char* buffer, std::size_t size, std::size_t offset) const {
+        const auto begin = offset / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+        const auto end   = (offset + size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+        std::unique_ptr<char[], aligned_deleter> bounce(
+            static_cast<char*>(::operator new[](end - begin, std::align_val_t {DIRECT_IO_ALIGNMENT})));
+
+        const auto read = pread_(bounce.get(), end - begin, begin);
+        if (!read.has_value()) {
+            return std::nullopt;
+        }
+        const auto skipped = offset - begin;
+        const auto copied  = std::min(size, *read > skipped ? *read - skipped : 0);
+        if (copied != 0) {
+            std::memcpy(buffer, bounce.get() + skipped, copied);
+        }
+        return copied;
+    }
+
+    [[nodiscard]] static constexpr bool is_aligned_(std::size_t value) { return value % DIRECT_IO_ALIGNMENT == 0; }
+
+  private:
+    int fd_ {-1};                        //!< file descriptor, negative if the file couldn't be opened
+    cache_mode mode_ {cache_mode::keep}; //!< usage of the page cache by the reads
+};
+
+} // namespace fil
+
+#endif // FIL_FILE_HANDLE_HH
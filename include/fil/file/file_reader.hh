@@ -25,13 +25,28 @@
 #define FILE_H
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
-
+#include <vector>
+
+#include "fil/algorithm/line_scan.hh"
+#include "fil/file/buffer_pool.hh"
+#include "fil/file/file_handle.hh"
+#include "fil/file/mapped_file.hh"
+#include "fil/file/read_ahead.hh"
+#include "fil/meta/line_index.hh"
 #include "fil/meta/reader.hh"
+#include "fil/meta/reader_stats.hh"
 #include "fil/meta/shallow_copy.hh"
 
 namespace fil {
@@ -42,6 +57,22 @@ namespace fil {
  */
 static constexpr std::size_t READER_BUFFER_SIZE = 1024 * 1024 + 1;
 
+/**
+ * max size of the unread data of a block carried over in front of the next block on load (64Kb), bigger leftovers are
+ * read again from the file
+ */
+static constexpr std::size_t READER_CARRY_OVER_SIZE = 64 * 1024;
+
+/**
+ * @brief options of a file_reader
+ */
+struct reader_options {
+    std::size_t block_size = READER_BUFFER_SIZE;        //!< number of bytes read from the file per load
+    std::shared_ptr<buffer_pool> pool {};               //!< pool the buffers are borrowed from, the process-wide pool if null
+    std::optional<read_ahead_mode> read_ahead {};       //!< read the next blocks in advance in a background thread if set
+    cache_mode cache = cache_mode::keep;                //!< usage of the page cache by the reads (drop behind, direct I/O)
+};
+
 /**
  * @brief Class responsible for reading and processing file data.
  *
@@ -62,8 +93,10 @@ class file_reader {
     class block_view {
         friend class file_reader;
 
+      public:
+        block_view() = default; //!< invalid block
+
       private:
-        block_view() = default;
         block_view(const std::string_view& block, std::size_t load_id_block, file_reader* reader)
             : block_(block)
             , load_id_block_(load_id_block)
@@ -86,38 +119,108 @@ class file_reader {
         file_reader* reader_ {};        //!< pointer to the file reader that contains the line
     };
 
+    /**
+     * @brief state of the reader saved by @c checkpoint() and restored by @c restore().
+     * If the buffer is still the same one at restoration, only the cursor is restored. Otherwise the block containing the
+     * checkpoint is re-loaded from the file.
+     */
+    struct checkpoint_type {
+        std::size_t cursor {0};        //!< cursor in the buffer at the moment of the checkpoint
+        std::size_t load_id {0};       //!< load id of the buffer at the moment of the checkpoint
+        std::size_t file_position {0}; //!< position in the file at the moment of the checkpoint
+    };
+
     template<std::invocable<std::string_view>>
     class iterator_file_ {};
 
-    class sentinel {};   //!< sentinel for end iteration
-    class line_iterator; //!< iterator that iterate through lines in the file
+    class sentinel {};           //!< sentinel for end iteration
+    class line_iterator;         //!< iterator that iterate through lines in the file
+    class reverse_line_iterator; //!< iterator that iterate through lines in the file, from the last one to the first one
 
     explicit file_reader(std::filesystem::path file_path)
+        : file_reader(std::move(file_path), reader_options {}) {}
+
+    /**
+     * @brief file reader with a specific block size and buffer pool
+     * @details the buffer is borrowed from the pool on the first load (a reader that isn't read doesn't cost a buffer)
+     * and given back on destruction or @c release_buffer. A file smaller than the block size is read at once into a
+     * buffer of its size.
+     * In direct mode (`cache_mode::direct`), the block size is rounded up to a multiple of DIRECT_IO_ALIGNMENT for the
+     * loads to read aligned blocks in place, bypassing the page cache.
+     * @param file_path path of the file to read
+     * @param options block size, buffer pool, read ahead and page cache configuration
+     */
+    file_reader(std::filesystem::path file_path, reader_options options)
         : file_path_(std::move(file_path))
-        , file_stream_(file_path_, std::ios::in | std::ios::binary)
-        , size_([this] -> std::size_t {
-            if (file_stream_.bad())
-                return 0;
-            file_stream_.seekg(0, std::ios::end);
-            const auto size = static_cast<std::uint32_t>(file_stream_.tellg());
-            file_stream_.seekg(0, std::ios::beg);
-            return size;
-        }()) {
-        current_buffer_.resize(READER_BUFFER_SIZE);
-        buffer_accessor_ = std::string_view(current_buffer_);
+        , file_(std::make_shared<const file_handle>(file_path_, options.cache))
+        , pool_(options.pool != nullptr ? std::move(options.pool) : buffer_pool::global())
+        , size_(file_->size()) {
+        // +1 : the read of a small file reaches its end at the first load
+        block_size_ = std::clamp<std::size_t>(size_ + 1, 1, std::max<std::size_t>(options.block_size, 1));
+        if (file_->is_direct()) {
+            block_size_ = (block_size_ + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+        }
+        headroom_ = std::min(READER_CARRY_OVER_SIZE, block_size_);
+        if (options.read_ahead.has_value()) {
+            read_ahead_ =
+                std::make_unique<details_::read_ahead_worker>(file_, options.read_ahead->in_flight, block_size_, headroom_, pool_);
+        }
+    }
+
+    /**
+     * @brief file reader reading the next blocks of the file in advance in a background thread
+     * @details a load of the next block of the file doesn't wait for the read anymore (as long as the consumer is slower
+     * than the disk), the I/O overlaps the processing of the current block. Each block read in advance costs a buffer.
+     * Non-sequential loads (read_line, restore...) are read synchronously and re-start the read ahead after them.
+     * @param file_path path of the file to read
+     * @param mode read ahead configuration
+     */
+    file_reader(std::filesystem::path file_path, read_ahead_mode mode)
+        : file_reader(std::move(file_path), reader_options {.read_ahead = mode}) {}
+
+    /**
+     * @brief enable the sparse line index used by @c read_line (and thus line_iterator construction)
+     * @details the index is built on the first call to @c read_line, and shared with the shallow copies of the reader.
+     * A line is then retrieved by jumping to the closest indexed line and skipping at most `stride - 1` lines, instead
+     * of skipping all the lines from the beginning of the file.
+     * @param stride number of lines in between two offsets stored in the index
+     * @param persist if true, the index is loaded from (and saved into) a sidecar file `<file>.lidx` keyed by the size
+     *                and the last modification time of the file
+     */
+    void enable_line_index(std::size_t stride = line_index::DEFAULT_STRIDE, bool persist = false) {
+        line_index_         = std::make_shared<line_index>(stride);
+        persist_line_index_ = persist;
     }
 
+    /**
+     * @return path of the sidecar file used to persist the line index
+     */
+    [[nodiscard]] std::filesystem::path line_index_path() const { return std::filesystem::path(file_path_).concat(".lidx"); }
+
     block_view read_line(std::size_t line) {
         buffer_size_ = 0;
-        file_stream_.clear();
-        file_stream_.seekg(0, std::ios::beg);
+        end_of_file_ = false;
+        if (line == 0) {
+            return {};
+        }
 
-        for (std::uint32_t i = 0; i < line - 1; ++i) {
-            file_stream_.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            if (file_stream_.eof() || file_stream_.fail()) {
+        std::size_t position      = 0;
+        std::size_t lines_to_skip = line - 1;
+        if (line_index_ != nullptr) {
+            build_line_index_();
+            const auto location = line_index_->locate(line);
+            if (!location.has_value()) {
                 return {};
             }
+            position      = location->offset;
+            lines_to_skip = location->lines_to_skip;
+        }
+
+        const auto line_position = skip_lines_(position, lines_to_skip);
+        if (!line_position.has_value()) {
+            return {};
         }
+        file_position_ = line_position.value();
         load_();
 
         return next_line();
@@ -127,7 +230,7 @@ class file_reader {
      * @brief Reads from the current buffer position until the predicate returns true for the accumulated string view.
      *
      * If the buffer doesn't have enough data remaining (less than minimum_size bytes), it triggers a buffer reload
-     * before starting the read operation.
+     * before starting the read operation (the data remaining is kept in front of the newly loaded block).
      *
      * @tparam Predicate A callable type that takes a std::string_view and returns a boolean
      * @param predicate A function or callable object that determines when to stop reading. It receives the accumulated
@@ -138,7 +241,7 @@ class file_reader {
      */
     template<std::invocable<std::string_view> Predicate>
     [[nodiscard]] block_view read_until(Predicate&& predicate, std::size_t minimum_size = 100) {
-        if (buffer_accessor_.front() != '\0' || ((buffer_size_ - cursor_) <= minimum_size)) {
+        if (buffer_size_ == 0 || ((buffer_size_ - cursor_) <= minimum_size)) {
             load_();
         }
         const auto start_cursor = cursor_;
@@ -180,17 +283,163 @@ class file_reader {
             return {};
         }
 
-        const auto pos       = std::find_if(std::next(buffer_accessor_.begin(), cursor_), buffer_accessor_.end(),
-                                            [](auto c) { return c == '\n' || c == '\0'; });
-        const auto size_line = std::distance(std::next(buffer_accessor_.begin(), cursor_), pos);
+        const char* begin = buffer_accessor_.data() + cursor_;
+        const char* pos   = find_newline(begin, buffer_accessor_.data() + buffer_size_);
+        while (pos == buffer_accessor_.data() + buffer_size_ && !end_of_file_) {
+            if (line_fits_reload_()) {
+                // the line continues in the next block: the beginning of the line is carried over in front of it
+                load_();
+            } else if (!append_end_of_line_()) {
+                break; // the line is bigger than the buffer: it is split
+            }
+            if (buffer_size_ == 0) {
+                cursor_ = std::numeric_limits<decltype(cursor_)>::max();
+                return {};
+            }
+            begin = buffer_accessor_.data() + cursor_;
+            pos   = find_newline(begin, buffer_accessor_.data() + buffer_size_);
+        }
 
-        std::string_view line {buffer_accessor_.data() + cursor_, static_cast<std::size_t>(size_line)};
+        std::string_view line {begin, static_cast<std::size_t>(pos - begin)};
 
-        cursor_ = std::distance(buffer_accessor_.begin(), pos) + 1; // move past the newline character
+        cursor_ = static_cast<std::size_t>(pos - buffer_accessor_.data()) + 1; // move past the newline character
 
         return {line, load_counter_, this};
     }
 
+    /**
+     * @brief retrieve the line ending right before the cursor (the part of the line preceding the cursor if it is in the
+     * middle of a line), and move the cursor backward to its beginning
+     *
+     * @details The blocks are read backward from the cursor: a line overlapping the beginning of the block is retrieved
+     * by loading the block ending at the end of the line. The previous end of line is searched with
+     * @c find_last_newline. As for @c next_line, a line bigger than the buffer is split.
+     *
+     * @return the previous line (without its end of line character), invalid if the cursor is at the beginning of the file
+     */
+    [[nodiscard]] block_view previous_line() {
+        const auto position = position_();
+        if (position == 0) {
+            return {};
+        }
+        if (position <= buffer_file_position_ || position > buffer_file_position_ + buffer_size_) {
+            load_backward_(position);
+        }
+
+        const auto find_line = [this, position](std::size_t& line_begin) {
+            const char* data = buffer_accessor_.data();
+            auto line_end    = std::min(position - buffer_file_position_, buffer_size_);
+            if (line_end != 0 && data[line_end - 1] == '\n') {
+                --line_end; // the end of line of the previous line isn't part of it
+            }
+            const char* found = find_last_newline(data, data + line_end);
+            line_begin        = found == data + line_end ? 0 : static_cast<std::size_t>(found - data) + 1;
+            return line_end;
+        };
+
+        std::size_t line_begin = 0;
+        auto line_end          = find_line(line_begin);
+        if (line_begin == 0 && buffer_file_position_ != 0 && position - buffer_file_position_ < headroom_ + block_size_) {
+            // the line begins before the block: the biggest block ending at the cursor is loaded
+            load_backward_(position);
+            line_end = find_line(line_begin);
+        }
+        if (buffer_size_ == 0) {
+            return {};
+        }
+
+        cursor_ = line_begin;
+        return {buffer_accessor_.substr(line_begin, line_end - line_begin), load_counter_, this};
+    }
+
+    /**
+     * @brief retrieve the last lines of the file, the file is read backward from its end (its beginning isn't read)
+     * @details the cursor is moved at the beginning of the first line retrieved: @c next_line retrieves them again.
+     * @param count number of lines to retrieve
+     * @return the `count` last lines of the file (all of them if the file has less), in the order of the file
+     */
+    [[nodiscard]] std::vector<std::string> tail(std::size_t count) {
+        seek_end_();
+        std::vector<std::string> lines;
+        while (lines.size() < count) {
+            const auto line = previous_line();
+            if (!line.is_valid()) {
+                break;
+            }
+            lines.emplace_back(line.get());
+        }
+        std::ranges::reverse(lines);
+        return lines;
+    }
+
+    /**
+     * @brief retrieve the next lines of the file in a batch
+     *
+     * @details The lines are all taken from the current block (the buffer is loaded only if none of the next line is
+     * complete in the current block): the views are valid up to the next load of the reader, as @c block_view are.
+     *
+     * @param lines filled with the next lines (without the end of line character), up to its size
+     * @return number of lines filled, 0 if the end of the file is reached
+     */
+    std::size_t next_lines(std::span<std::string_view> lines) {
+        if (lines.empty()) {
+            return 0;
+        }
+        if (cursor_ >= buffer_size_) {
+            load_();
+        }
+        auto [filled, consumed] = split_lines(current_block_(), lines, end_of_file_);
+        if (filled == 0 && buffer_size_ != 0 && cursor_ < buffer_size_) {
+            // the line at the cursor continues in the next block: it is read by next_line (carried over in front of the
+            // next block), the following lines being taken from the block it is read in
+            const auto line = next_line();
+            if (!line.is_valid()) {
+                return 0;
+            }
+            lines.front()              = line.get();
+            std::tie(filled, consumed) = split_lines(current_block_(), lines.subspan(1), end_of_file_);
+            ++filled;
+        }
+        if (filled == 0) {
+            cursor_ = std::numeric_limits<decltype(cursor_)>::max(); // force cursor at "end" for iterator
+            return 0;
+        }
+        cursor_ += consumed;
+        return filled;
+    }
+
+    /**
+     * @brief count the lines of the file, independently of the reading of the reader (the cursor isn't changed)
+     * @return number of lines of the file (a last line without end of line character is counted)
+     */
+    [[nodiscard]] std::size_t count_lines() const {
+        if (line_index_ != nullptr && line_index_->is_built()) {
+            return line_index_->line_count();
+        }
+        auto block = pool_->acquire(block_size_);
+
+        std::size_t newlines = 0;
+        std::size_t position = 0;
+        char last            = '\n';
+        while (const auto read = file_->read_at(block.data(), block.size(), position).value_or(0)) {
+            newlines += count_newlines(block.data(), block.data() + read);
+            last = block[read - 1];
+            position += read;
+        }
+        return newlines + (last != '\n' ? 1 : 0);
+    }
+
+    /**
+     * @brief load the block at the cursor if it isn't loaded yet, for the next read not to wait for the disk
+     * @return true if there is data to read at the cursor
+     */
+    bool prefetch() {
+        if (cursor_ >= buffer_size_) {
+            load_();
+        }
+        return cursor_ < buffer_size_;
+    }
+
     [[nodiscard]] std::optional<std::uint8_t> next_byte() {
         if (cursor_ >= buffer_size_) {
             load_();
@@ -201,11 +450,20 @@ class file_reader {
         return std::make_optional(buffer_accessor_[cursor_++]);
     }
 
+    /**
+     * @note the block preceding the current one is loaded only if the cursor is at the beginning of the current block
+     * @return the character preceding the cursor, if any (the cursor is moved backward)
+     */
     [[nodiscard]] std::optional<std::uint8_t> previous_byte() {
-        if ((cursor_ - 1) <= buffer_size_) {
-            load_();
+        if (cursor_ == 0 || cursor_ > buffer_size_) {
+            const auto position = position_();
+            if (position > buffer_file_position_) {
+                cursor_ = buffer_size_; // the cursor is past the end of the block
+            } else if (position != 0) {
+                load_backward_(position);
+            }
         }
-        if (buffer_size_ == 0 || cursor_ <= 0) {
+        if (cursor_ == 0) {
             return std::nullopt;
         }
         return std::make_optional(buffer_accessor_[--cursor_]);
@@ -217,81 +475,384 @@ class file_reader {
         return std::make_optional(buffer_accessor_[cursor_]);
     }
 
+    /**
+     * @return checkpoint of the current state of the reader, @see restore
+     */
+    [[nodiscard]] checkpoint_type checkpoint() const {
+        return {
+            .cursor        = cursor_,
+            .load_id       = load_counter_,
+            .file_position = buffer_file_position_ + cursor_,
+        };
+    }
+
+    /**
+     * @brief restore the reader at the state it had when the checkpoint was made
+     * @details if no load occurred since the checkpoint was made, only the cursor is restored, otherwise the block
+     * starting at the position of the checkpoint is loaded.
+     * @param checkpoint to restore the reader to
+     */
+    void restore(const checkpoint_type& checkpoint) {
+        if (checkpoint.load_id == load_counter_) {
+            if (const auto cursor = std::min(cursor_, buffer_size_); checkpoint.cursor < cursor) {
+                stats_.record_backtrack(cursor - checkpoint.cursor);
+            }
+            cursor_ = checkpoint.cursor;
+            return;
+        }
+        buffer_size_   = 0;
+        end_of_file_   = false;
+        file_position_ = checkpoint.file_position;
+        load_();
+    }
+
     [[nodiscard]] const std::filesystem::path& get_path() const { return file_path_; }
     [[nodiscard]] bool exists() const { return std::filesystem::exists(file_path_); }
-    [[nodiscard]] auto get_file_cursor() { return file_stream_.tellg(); }
+    [[nodiscard]] std::size_t get_file_cursor() const { return file_position_; }
     [[nodiscard]] std::size_t get_buffer_cursor() const { return cursor_; }
     [[nodiscard]] std::size_t reader_cursor() const { return get_buffer_cursor(); }
     [[nodiscard]] std::size_t size() const { return size_; }
     [[nodiscard]] std::size_t load_counter() const { return load_counter_; }
+    [[nodiscard]] bool is_read_ahead() const { return read_ahead_ != nullptr; }
+
+    /**
+     * @return usage of the page cache by the reads (`drop` if direct I/O was requested on a filesystem not supporting it)
+     */
+    [[nodiscard]] cache_mode cache() const { return file_ != nullptr ? file_->mode() : cache_mode::keep; }
+
+    /**
+     * @return I/O statistics of the buffer loads of the reader and of its shallow copies (all zeros if FIL_READER_STATS
+     * isn't defined)
+     */
+    [[nodiscard]] reader_stats stats() const { return stats_.snapshot(); }
+    [[nodiscard]] std::size_t block_size() const { return block_size_; }
+
+    /**
+     * @return size of the buffer currently borrowed by the reader, 0 if it has none
+     */
+    [[nodiscard]] std::size_t buffer_capacity() const { return current_buffer_.size(); }
+
+    /**
+     * @brief give the buffers of the reader back to its pool, for a reader that is kept open but not read for a while
+     * @details the blocks retrieved become invalid, the next read re-loads the block at the position of the cursor
+     * (the cursor is kept).
+     */
+    void release_buffer() {
+        if (buffer_size_ != 0) {
+            file_position_ = position_();
+        }
+        buffer_file_position_ = file_position_;
+        buffer_size_          = 0;
+        cursor_               = 0;
+        end_of_file_          = false;
+        buffer_accessor_      = {};
+        current_buffer_.reset();
+        spare_buffer_.reset();
+        ++load_counter_;
+    }
 
     [[nodiscard]] file_reader::line_iterator make_line_iterator(std::size_t start = 1);
+    [[nodiscard]] file_reader::reverse_line_iterator make_reverse_line_iterator();
     [[nodiscard]] file_reader::sentinel end() { return {}; }
 
   private:
     file_reader() = default;
 
+    /**
+     * @return view on the part of the current block not read yet
+     */
+    [[nodiscard]] std::string_view current_block_() const {
+        if (cursor_ >= buffer_size_) {
+            return {};
+        }
+        return buffer_accessor_.substr(cursor_, buffer_size_ - cursor_);
+    }
+
+    /**
+     * @details the buffer doesn't necessarily start at a load of the reader (a block loaded backward ends before the end
+     * of the file, the cursor being possibly at its beginning): what matters is if a load gives more of the line.
+     * @return true if a load retrieves more of the data following the cursor than the current block (the data is carried
+     * over in front of the next block, or read again from the cursor if bigger than the headroom)
+     */
+    [[nodiscard]] bool line_fits_reload_() const {
+        const auto remaining = buffer_size_ - std::min(cursor_, buffer_size_);
+        return remaining <= headroom_ || remaining < block_size_;
+    }
+
+    /**
+     * @brief append the byte following the block to it if it is an end of line: the end of line of a line filling the
+     * buffer is consumed with it (instead of being read as an empty line)
+     * @details the buffer has room for one byte past the block and its null-terminator. A shallow copy that didn't load
+     * yet copies the block in a buffer of its own first.
+     * @return true if an end of line has been appended
+     */
+    bool append_end_of_line_() {
+        char next = '\0';
+        if (file_ == nullptr || file_->read_at(&next, 1, file_position_).value_or(0) != 1 || next != '\n') {
+            return false;
+        }
+        stats_.record_read(file_position_, 1);
+        if (current_buffer_.size() < buffer_capacity_()) {
+            auto buffer = pool_->acquire(buffer_capacity_());
+            std::memcpy(buffer.data(), buffer_accessor_.data(), buffer_size_);
+            current_buffer_  = std::move(buffer);
+            buffer_accessor_ = buffer_view_(0);
+        }
+        const auto end           = static_cast<std::size_t>(buffer_accessor_.data() - current_buffer_.data()) + buffer_size_;
+        current_buffer_[end]     = '\n';
+        current_buffer_[end + 1] = '\0';
+        ++buffer_size_;
+        ++file_position_;
+        return true;
+    }
+
+    /**
+     * @brief skip lines from a position in the file, without loading them in the buffer
+     * @param position in the file to start skipping lines from
+     * @param count number of lines to skip
+     * @return position of the beginning of the line following the skipped lines, nullopt if the end of the file is
+     * reached before
+     */
+    [[nodiscard]] std::optional<std::size_t> skip_lines_(std::size_t position, std::size_t count) const {
+        std::string block(count == 0 ? 0 : READER_CARRY_OVER_SIZE, '\0');
+        while (count > 0) {
+            const auto read = file_->read_at(block.data(), block.size(), position).value_or(0);
+            if (read == 0) {
+                return std::nullopt;
+            }
+            const char* it  = block.data();
+            const char* end = it + read;
+            for (const char* newline = find_newline(it, end); count > 0 && newline != end; newline = find_newline(it, end)) {
+                it = newline + 1;
+                --count;
+            }
+            position += count == 0 ? static_cast<std::size_t>(it - block.data()) : read;
+        }
+        return position;
+    }
+
+    /**
+     * @brief build the line index if not built yet, from its sidecar file if persisted and up to date
+     */
+    void build_line_index_() {
+        if (line_index_->is_built()) {
+            return;
+        }
+        std::error_code ec;
+        const auto file_size         = std::filesystem::file_size(file_path_, ec);
+        const auto modification_time = std::filesystem::last_write_time(file_path_, ec).time_since_epoch().count();
+
+        if (persist_line_index_) {
+            if (auto index = line_index::load(line_index_path(), file_size, modification_time); index.has_value()) {
+                *line_index_ = std::move(index.value());
+                return;
+            }
+        }
+        const mapped_file file(file_path_);
+        file.advise(access_advice::sequential);
+        *line_index_ = line_index::build(file.view(), line_index_->stride());
+
+        if (persist_line_index_) {
+            line_index_->save(line_index_path(), file_size, modification_time);
+        }
+    }
+
     /**
      * @brief Loads a block of data from the file into the buffer.
      *
-     * @details This method reads a block of data from the file stream into the buffer and updates
-     * internal state variables accordingly. If the buffer already contains unread data, the
-     * cursor in the file stream is moved backward to account for the leftover data before loading.
+     * @details This method reads the next block of data from the file stream into the buffer and updates internal state
+     * variables accordingly. The data of the current block not read yet (from the cursor to the end of the block) is
+     * carried over: it is copied in front of the new block, so that only new bytes are read from the file and a token
+     * or a line overlapping two blocks is contiguous in the buffer.
      * It increments the load counter to track the number of load operations performed.
      *
      * Behavior:
      * - If the end of the file is reached, no actions are performed, and the method returns early.
-     * - If the last read operation left unread data in the buffer, the file stream's cursor is
-     *   adjusted to include that data in the next read operation.
-     * - Resets the internal buffer state before attempting further reads.
-     * - Reads up to `READER_BUFFER_SIZE` bytes from the file stream into the buffer. If no data can
+     * - The buffer is borrowed from the pool at the first load (or after @c release_buffer).
+     * - The buffer reserves `READER_CARRY_OVER_SIZE` bytes (at most the block size) in front of the block for the
+     *   carried over data. Bigger leftovers are read again from the file (the file stream's cursor is moved backward).
+     * - In read ahead mode, the block already read by the background worker is taken if it starts at the position to
+     *   load (sequential read), otherwise the block is read synchronously and the read ahead re-starts after it.
+     * - Reads up to `block_size` bytes from the file stream into the buffer. If no data can
      *   be read (e.g., due to an error or end-of-file), the buffer size remains at zero.
+     * - In direct mode, the block is read from the aligned position preceding the position to load, the bytes in between
+     *   being read again (the carried over data they overlap is overwritten by the same bytes).
      * - Adds a null-terminator at the end of the loaded buffer for safe string operations.
      *
      * Preconditions:
      * - The file stream must be open and ready for reading.
      *
      * Postconditions:
-     * - The buffer contains data read from the file, up to `READER_BUFFER_SIZE` bytes, or remains
-     *   empty if no data could be read.
-     * - The cursor is reset, and the buffer size is updated to reflect the amount of data read.
+     * - The buffer contains the carried over data followed by the data read from the file, up to `block_size` bytes,
+     *   or remains empty if no data could be read.
+     * - The cursor is reset, and the buffer size is updated to reflect the amount of data available.
      */
     void load_() {
-        if (file_stream_.eof())
+        if (end_of_file_)
             return;
 
-        if (buffer_size_ != 0) {
+        std::size_t carry_over = (buffer_size_ != 0 && cursor_ < buffer_size_) ? buffer_size_ - cursor_ : 0;
+        if (carry_over > headroom_) {
             // move cursor backward to the last read position to retrieve the same leftover of buffer that was not read
-            if (cursor_ < buffer_accessor_.size()) {
-                file_stream_.seekg(-static_cast<int64_t>(buffer_accessor_.size() - cursor_), std::ios::cur);
-            }
+            file_position_ -= carry_over;
+            carry_over = 0;
         }
+        const char* leftover = carry_over != 0 ? buffer_accessor_.data() + cursor_ : nullptr;
         ++load_counter_;
+        stats_.record_load();
 
         buffer_size_ = 0;
         cursor_      = 0;
 
-        if (!file_stream_.good() || file_stream_.eof()) {
-            return; // No more data to read
+        if (file_ == nullptr || !file_->is_open()) {
+            return; // No data to read
         }
 
-        file_stream_.read(&current_buffer_[0], READER_BUFFER_SIZE);
-        buffer_size_                  = file_stream_.gcount();
-        current_buffer_[buffer_size_] = '\0';
-        buffer_accessor_              = std::string_view(current_buffer_);
+        const auto read_position = file_position_;
+        std::size_t read_size    = 0;
+        std::size_t skipped      = 0;
+        bool end_of_file         = false;
+        if (read_ahead_ != nullptr && stats_.timed([&] { return read_ahead_->take(read_position, spare_buffer_, read_size); })) {
+            // the block has been read in advance
+            if (carry_over != 0) {
+                std::memcpy(spare_buffer_.data() + headroom_ - carry_over, leftover, carry_over);
+            }
+            std::swap(current_buffer_, spare_buffer_);
+            end_of_file = read_size < block_size_;
+        } else {
+            // a direct read of an unaligned position reads from the aligned position preceding it: the block is placed
+            // `skipped` bytes further in the buffer
+            skipped = is_direct_() ? read_position % DIRECT_IO_ALIGNMENT : 0;
+            if (current_buffer_.size() < buffer_capacity_()) {
+                // first load (or shallow copy loading for the first time: the leftover is in the buffer of the reader it
+                // comes from)
+                auto buffer = pool_->acquire(buffer_capacity_());
+                if (carry_over != 0) {
+                    std::memcpy(buffer.data() + headroom_ + skipped - carry_over, leftover, carry_over);
+                }
+                current_buffer_ = std::move(buffer);
+            } else if (carry_over != 0) {
+                std::memmove(current_buffer_.data() + headroom_ + skipped - carry_over, leftover, carry_over);
+            }
+            const auto read = stats_.timed([&] {
+                return file_->read_at(current_buffer_.data() + headroom_, block_size_, read_position - skipped);
+            }).value_or(0);
+            read_size   = read > skipped ? read - skipped : 0;
+            end_of_file = read < block_size_;
+            if (read_ahead_ != nullptr) {
+                read_ahead_->restart(read_position + read_size);
+            }
+        }
+        stats_.record_read(read_position - skipped, skipped + read_size);
+        file_position_        = read_position + read_size;
+        end_of_file_          = end_of_file;
+        buffer_file_position_ = read_position - carry_over;
+        buffer_size_          = carry_over + read_size;
+
+        current_buffer_[headroom_ + skipped + read_size] = '\0';
+        buffer_accessor_ = buffer_view_(headroom_ + skipped - carry_over);
     }
 
-  private:
-    std::filesystem::path file_path_;     //!< path to the file to read
+    /**
+     * @brief load the block ending at the provided position (with the room of the carried over data in front of the
+     * block, thus up to `headroom + block_size` bytes), the cursor is set at the end of the block
+     * @details in direct mode, the block read starts at the preceding aligned position (up to DIRECT_IO_ALIGNMENT bytes
+     * more) and its size is rounded up (the bytes read past the end aren't part of the block).
+     * @param end position in the file of the end of the block
+     */
+    void load_backward_(std::size_t end) {
+        ++load_counter_;
+        stats_.record_load();
+        buffer_size_ = 0;
+        cursor_      = 0;
+        if (file_ == nullptr || !file_->is_open()) {
+            return;
+        }
+        if (current_buffer_.size() < buffer_capacity_()) {
+            current_buffer_ = pool_->acquire(buffer_capacity_());
+        }
+        auto begin = end - std::min(end, headroom_ + block_size_);
+        auto size  = end - begin;
+        if (is_direct_()) {
+            begin = begin / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+            size  = (end - begin + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+        }
+        const auto read_size = stats_.timed([&] { return file_->read_at(current_buffer_.data(), size, begin); }).value_or(0);
+        const auto read      = std::min(read_size, end - begin); // the bytes read past the end aren't part of the block
+        stats_.record_read(begin, read);
+
+        buffer_file_position_ = begin;
+        file_position_        = begin + read;
+        end_of_file_          = false;
+        buffer_size_          = read;
+        cursor_               = read;
+
+        current_buffer_[read] = '\0';
+        buffer_accessor_      = buffer_view_(0);
+    }
+
+    /**
+     * @brief move the cursor to a position in the file, the block is loaded by the next read if the position isn't in
+     * the current block
+     */
+    void seek_(std::size_t position) {
+        if (buffer_size_ != 0 && position >= buffer_file_position_ && position <= buffer_file_position_ + buffer_size_) {
+            cursor_ = position - buffer_file_position_;
+            return;
+        }
+        file_position_        = position;
+        buffer_file_position_ = position;
+        buffer_size_          = 0;
+        cursor_               = 0;
+        end_of_file_          = false;
+    }
+
+    void seek_end_() { seek_(file_ != nullptr ? file_->size() : 0); }
+
+    /**
+     * @return position in the file of the cursor
+     */
+    [[nodiscard]] std::size_t position_() const { return buffer_file_position_ + std::min(cursor_, buffer_size_); }
+
+    /**
+     * @return size of the buffer: room for the carried over data, the block, the end of line following a line filling
+     * the buffer and the null-terminator (in direct mode, room for the aligned read of a backward load)
+     */
+    [[nodiscard]] std::size_t buffer_capacity_() const { return headroom_ + block_size_ + (is_direct_() ? DIRECT_IO_ALIGNMENT : 2); }
 
-    std::ifstream file_stream_;           //!< file stream to read from
-    std::string current_buffer_ {};       //!< buffer of the current read
-    std::string_view buffer_accessor_ {}; //!< access point to the buffer
-    std::size_t buffer_size_ {0};         //!< size of the buffer
-    std::size_t cursor_ {0};              //!< cursor in the buffer of the current block
+    [[nodiscard]] bool is_direct_() const { return file_ != nullptr && file_->is_direct(); }
+
+    /**
+     * @return view on the buffer from the provided offset to the end of the buffer
+     */
+    [[nodiscard]] std::string_view buffer_view_(std::size_t offset) const {
+        return {current_buffer_.data() + offset, current_buffer_.size() - offset};
+    }
 
-    std::size_t size_ {0};                //!< file size in bytes
-    std::size_t load_counter_ {0};        //!< counter to inform on how many load occurred
+  private:
+    std::filesystem::path file_path_;      //!< path to the file to read
+
+    std::shared_ptr<const file_handle> file_; //!< file to read from, shared with the shallow copies (positional reads)
+    std::size_t file_position_ {0};           //!< position in the file of the next read
+    bool end_of_file_ {false};                //!< true once a read reached the end of the file
+
+    std::shared_ptr<buffer_pool> pool_;    //!< pool the buffers are borrowed from
+    std::size_t block_size_ {READER_BUFFER_SIZE};   //!< number of bytes read per load
+    std::size_t headroom_ {READER_CARRY_OVER_SIZE}; //!< room for the carried over data in front of the block
+    pooled_buffer current_buffer_ {};      //!< buffer of the current read
+    pooled_buffer spare_buffer_ {};        //!< buffer exchanged with the read ahead worker, if in read ahead mode
+    std::string_view buffer_accessor_ {};  //!< access point to the buffer
+    std::size_t buffer_size_ {0};          //!< size of the buffer
+    std::size_t cursor_ {0};               //!< cursor in the buffer of the current block
+    std::size_t buffer_file_position_ {0}; //!< position in the file of the beginning of the current block
+
+    std::size_t size_ {0};                 //!< file size in bytes
+    std::size_t load_counter_ {0};         //!< counter to inform on how many load occurred
+
+    std::unique_ptr<details_::read_ahead_worker> read_ahead_; //!< background reader of the next blocks, if in read ahead mode
+    std::shared_ptr<line_index> line_index_;                  //!< sparse line index shared with shallow copies, if enabled
+    bool persist_line_index_ {false};                         //!< true if the line index is persisted in a sidecar file
+    [[no_unique_address]] details_::stats_recorder<> stats_;  //!< I/O statistics, shared with the shallow copies
 };
 
 /**
@@ -338,6 +899,42 @@ class file_reader::line_iterator {
     return file_reader::line_iterator(this, start);
 }
 
+/**
+ * @brief iterator through the lines of a read_file from the end of the file to its beginning
+ * @details the blocks of the file are read backward from its end, @see file_reader::previous_line
+ */
+class file_reader::reverse_line_iterator {
+  public:
+    explicit reverse_line_iterator(file_reader* file_handler)
+        : file_handler_(file_handler) {
+        file_handler_->seek_end_();
+        operator++();
+    }
+
+    const block_view& operator*() const { return line_; }
+    const block_view* operator->() const { return &line_; }
+
+    reverse_line_iterator& operator++() {
+        if (!end_) {
+            line_ = file_handler_->previous_line();
+            end_  = !line_.is_valid();
+        }
+        return *this;
+    }
+
+    bool operator!=(file_reader::sentinel) const { return !end_; }
+    bool operator==(file_reader::sentinel s) const { return !(operator!=(s)); }
+
+  private:
+    file_reader* file_handler_;
+    block_view line_ {};
+    bool end_ {false};
+};
+
+[[nodiscard]] inline file_reader::reverse_line_iterator file_reader::make_reverse_line_iterator() {
+    return file_reader::reverse_line_iterator(this);
+}
+
 /**
  * @brief wrapper around file_handler to manipulate lines per lines through a range interface
  */
@@ -355,32 +952,62 @@ class file_reader_line {
     std::size_t start_line_;
 };
 
+/**
+ * @brief wrapper around file_handler to manipulate lines per lines, from the last one to the first one, through a range
+ * interface
+ */
+class file_reader_reverse_line {
+  public:
+    explicit file_reader_reverse_line(file_reader& file_handler)
+        : file_handler_(&file_handler) {}
+
+    file_reader::reverse_line_iterator begin() const { return file_handler_->make_reverse_line_iterator(); }
+    file_reader::sentinel end() const { return file_handler_->end(); }
+
+  private:
+    file_reader* file_handler_;
+};
+
 static_assert(meta::bytes_reader<file_reader>, "buffer_reader must be a byte reader");
 static_assert(meta::line_reader<file_reader>, "buffer_reader must be a line reader");
+static_assert(meta::checkpoint_reader<file_reader>, "file_reader must be a checkpoint reader");
 
 template<>
 struct shallow_copy<file_reader> {
     static constexpr auto copy(file_reader& object) {
         file_reader shallow;
 
-        shallow.file_stream_ = std::ifstream(object.file_path_);
-        shallow.file_stream_.seekg(object.file_stream_.tellg());
-
-        shallow.buffer_size_     = object.buffer_size_;
-        shallow.cursor_          = object.cursor_;
-        shallow.size_            = object.size_;
-        shallow.file_path_       = object.file_path_;
-        shallow.buffer_accessor_ = object.buffer_accessor_;
-        shallow.load_counter_    = 0;
+        shallow.file_          = object.file_;
+        shallow.file_position_ = object.file_position_;
+        shallow.end_of_file_   = object.end_of_file_;
+
+        shallow.buffer_size_          = object.buffer_size_;
+        shallow.cursor_               = object.cursor_;
+        shallow.size_                 = object.size_;
+        shallow.buffer_file_position_ = object.buffer_file_position_;
+        shallow.file_path_            = object.file_path_;
+        shallow.pool_                 = object.pool_;
+        shallow.block_size_           = object.block_size_;
+        shallow.headroom_             = object.headroom_;
+        shallow.buffer_accessor_      = object.buffer_accessor_;
+        shallow.load_counter_         = 0;
+        shallow.line_index_           = object.line_index_;
+        shallow.persist_line_index_   = object.persist_line_index_;
+        object.stats_.record_shallow_copy();
+        shallow.stats_ = object.stats_;
         return shallow;
     }
 
     static constexpr auto assign(file_reader& object, file_reader&& other) {
-        object.file_stream_.seekg(other.file_stream_.tellg());
-        object.cursor_ = other.cursor_;
+        object.file_position_ = other.file_position_;
+        object.end_of_file_   = other.end_of_file_;
+        object.cursor_        = other.cursor_;
         if (other.load_counter() > 0) {
+            const auto offset = static_cast<std::size_t>(other.buffer_accessor_.data() - other.current_buffer_.data());
             std::swap(object.current_buffer_, other.current_buffer_);
-            object.buffer_accessor_ = std::string_view(object.current_buffer_);
+            object.buffer_accessor_      = object.buffer_view_(offset);
+            object.buffer_size_          = other.buffer_size_;
+            object.buffer_file_position_ = other.buffer_file_position_;
         }
     }
 };
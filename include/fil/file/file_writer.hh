@@ -0,0 +1,425 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_FILE_WRITER_HH
+#define FIL_FILE_WRITER_HH
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "fil/meta/reader.hh"
+
+namespace fil {
+
+static constexpr std::size_t WRITER_BUFFER_SIZE = 1024 * 1024; //!< default size of the buffer of a file_writer (1Mb)
+static constexpr std::size_t WRITER_ALIGNMENT   = 4096;        //!< alignment of the buffer (and of the writes in direct mode)
+
+/**
+ * @brief policy of synchronisation of the written data to the storage (`fdatasync`)
+ */
+enum class sync_policy {
+    none,          //!< the kernel writes the data back when it wants (sync only on explicit call to @c file_writer::sync)
+    every_n_bytes, //!< sync each time `sync_bytes` bytes have been written since the last sync
+    group_commit,  //!< sync at most every `sync_interval`, the writes in between being committed together
+};
+
+/**
+ * @brief options of a @c file_writer
+ */
+struct writer_options {
+    std::size_t buffer_size = WRITER_BUFFER_SIZE;  //!< size of the buffer, rounded up to a multiple of WRITER_ALIGNMENT
+    bool append             = false;               //!< append to the existing file instead of truncating it
+    bool direct_io          = false;               //!< bypass the page cache (O_DIRECT), if supported by the filesystem
+    sync_policy sync        = sync_policy::none;   //!< synchronisation of the data to the storage
+    std::size_t sync_bytes  = 64 * 1024 * 1024;    //!< bytes in between two syncs for sync_policy::every_n_bytes
+    bool background_flush   = false;               //!< flush the buffer (and group commit) from a background thread
+    std::chrono::milliseconds sync_interval {100}; //!< period of the group commit and of the background flush
+};
+
+namespace details_ {
+
+struct aligned_deleter {
+    void operator()(char* buffer) const { ::operator delete[](buffer, std::align_val_t {WRITER_ALIGNMENT}); }
+};
+
+} // namespace details_
+
+/**
+ * @brief Buffered writer of a file, counterpart of the file_reader.
+ *
+ * @details Small appends are copied in a buffer written to the file once full, big appends (and batches of appends)
+ * are written along with the buffer in a single vectored write (`writev`) without being copied. In direct mode
+ * (`O_DIRECT`), the writes bypass the page cache: only complete aligned blocks of the buffer are written, the tail of the
+ * file being written normally when the writer is closed.
+ *
+ * The I/O errors are sticky: once a write failed, the following writes are ignored and @c error() returns the error.
+ * The writer is closed (flushed and synced according to its policy) upon destruction.
+ */
+class file_writer {
+  public:
+    explicit file_writer(const std::filesystem::path& file_path, writer_options options = {})
+        : file_path_(file_path)
+        , options_(std::move(options))
+        , capacity_(std::max<std::size_t>((options_.buffer_size + WRITER_ALIGNMENT - 1) / WRITER_ALIGNMENT, 1) * WRITER_ALIGNMENT)
+        , buffer_(static_cast<char*>(::operator new[](capacity_, std::align_val_t {WRITER_ALIGNMENT}))) {
+        const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (options_.append ? O_APPEND : O_TRUNC);
+        if (options_.direct_io) {
+            fd_     = ::open(file_path.c_str(), flags | O_DIRECT, 0644);
+            direct_ = fd_ >= 0 && (!options_.append || is_aligned_(file_size_()));
+            if (fd_ >= 0 && !direct_) {
+                set_direct_(false); // appending after an unaligned end of file: direct writes would be rejected
+            }
+        }
+        if (fd_ < 0) {
+            // O_DIRECT isn't supported by every filesystem (tmpfs for instance)
+            fd_ = ::open(file_path.c_str(), flags, 0644);
+        }
+        if (fd_ < 0) {
+            error_ = std::error_code(errno, std::generic_category());
+            return;
+        }
+        last_sync_ = std::chrono::steady_clock::now();
+        if (options_.background_flush) {
+            flusher_ = std::jthread([this](std::stop_token stop) { background_flush_(stop); });
+        }
+    }
+
+    ~file_writer() { close(); }
+
+    file_writer(const file_writer&)            = delete;
+    file_writer& operator=(const file_writer&) = delete;
+
+    /**
+     * @brief append data to the file
+     */
+    void write(std::string_view data) {
+        auto lock = lock_();
+        write_(data);
+    }
+
+    /**
+     * @brief append a line (followed by an end of line character) to the file
+     */
+    void write_line(std::string_view line) {
+        auto lock = lock_();
+        write_(line);
+        write_("\n");
+    }
+
+    /**
+     * @brief append several pieces of data to the file, written in a single vectored write if they don't fit the buffer
+     */
+    void write(std::span<const std::string_view> pieces) {
+        auto lock = lock_();
+        std::size_t total = 0;
+        for (const auto piece : pieces) {
+            total += piece.size();
+        }
+        if (direct_ || size_ + total <= capacity_) {
+            for (const auto piece : pieces) {
+                write_(piece);
+            }
+            return;
+        }
+        std::vector<iovec> vectors;
+        vectors.reserve(pieces.size() + 1);
+        vectors.push_back({buffer_.get(), size_});
+        for (const auto piece : pieces) {
+            vectors.push_back({const_cast<char*>(piece.data()), piece.size()});
+        }
+        write_vectors_(vectors);
+        size_ = 0;
+    }
+
+    /**
+     * @brief write the content of the buffer to the file (in direct mode, only the complete aligned blocks)
+     * @return false if an I/O error occurred
+     */
+    bool flush() {
+        auto lock = lock_();
+        flush_();
+        return !error_;
+    }
+
+    /**
+     * @brief flush the buffer and synchronise the data written to the storage (`fdatasync`)
+     * @return false if an I/O error occurred
+     */
+    bool sync() {
+        auto lock = lock_();
+        flush_();
+        sync_();
+        return !error_;
+    }
+
+    /**
+     * @brief flush the remaining data (synchronised to the storage if the policy isn't sync_policy::none) and close the file
+     * @return false if an I/O error occurred
+     */
+    bool close() {
+        if (flusher_.joinable()) {
+            flusher_.request_stop(); // interrupts the wait of the background flush thread
+            flusher_.join();
+        }
+        if (fd_ < 0) {
+            return !error_;
+        }
+        flush_();
+        if (size_ > 0) {
+            // the unaligned tail of the file can't be written in direct mode
+            set_direct_(false);
+            std::array tail {iovec {buffer_.get(), size_}};
+            write_vectors_(tail);
+            size_ = 0;
+        }
+        if (options_.sync != sync_policy::none) {
+            sync_();
+        }
+        ::close(fd_);
+        fd_ = -1;
+        return !error_;
+    }
+
+    /**
+     * @return true if the file is opened and no I/O error occurred
+     */
+    [[nodiscard]] bool is_open() const { return fd_ >= 0 && !error_; }
+
+    /**
+     * @return true if the writes bypass the page cache (O_DIRECT requested and supported)
+     */
+    [[nodiscard]] bool is_direct() const { return direct_; }
+
+    /**
+     * @return first I/O error that occurred, empty if none
+     */
+    [[nodiscard]] std::error_code error() const { return error_; }
+
+    /**
+     * @return number of bytes appended to the writer (written to the file or still buffered)
+     */
+    [[nodiscard]] std::size_t bytes_written() const {
+        auto lock = lock_();
+        return written_ + size_;
+    }
+
+    [[nodiscard]] const std::filesystem::path& get_path() const { return file_path_; }
+
+  private:
+    [[nodiscard]] std::unique_lock<std::mutex> lock_() const {
+        // the mutex is only required to share the buffer with the background flush thread
+        return options_.background_flush ? std::unique_lock(mutex_) : std::unique_lock<std::mutex> {};
+    }
+
+    void write_(std::string_view data) {
+        if (error_) {
+            return;
+        }
+        if (size_ + data.size() <= capacity_) {
+            std::memcpy(buffer_.get() + size_, data.data(), data.size());
+            size_ += data.size();
+            return;
+        }
+        if (!direct_) {
+            // the buffer and the data are written together, without copying the data
+            std::array vectors {iovec {buffer_.get(), size_}, iovec {const_cast<char*>(data.data()), data.size()}};
+            write_vectors_(vectors);
+            size_ = 0;
+            return;
+        }
+        while (!data.empty() && !error_) {
+            const auto size = std::min(capacity_ - size_, data.size());
+            std::memcpy(buffer_.get() + size_, data.data(), size);
+            size_ += size;
+            data.remove_prefix(size);
+            if (size_ == capacity_) {
+                flush_();
+            }
+        }
+    }
+
+    void flush_() {
+        if (error_ || size_ == 0) {
+            return;
+        }
+        const auto size = direct_ ? size_ / WRITER_ALIGNMENT * WRITER_ALIGNMENT : size_;
+        if (size == 0) {
+            return;
+        }
+        std::array vectors {iovec {buffer_.get(), size}};
+        write_vectors_(vectors);
+        std::memmove(buffer_.get(), buffer_.get() + size, size_ - size);
+        size_ -= size;
+    }
+
+    /**
+     * @brief write all the vectors to the file, in as few `writev` calls as possible
+     */
+    void write_vectors_(std::span<iovec> vectors) {
+        std::size_t total = 0;
+        for (const auto& vector : vectors) {
+            total += vector.iov_len;
+        }
+        while (!vectors.empty() && !error_) {
+            const auto count  = static_cast<int>(std::min<std::size_t>(vectors.size(), IOV_MAX));
+            const auto result = ::writev(fd_, vectors.data(), count);
+            if (result < 0) {
+                if (errno != EINTR) {
+                    error_ = std::error_code(errno, std::generic_category());
+                }
+                continue;
+            }
+            // skip the vectors written, and the written part of a partially written vector
+            auto written = static_cast<std::size_t>(result);
+            while (!vectors.empty() && written >= vectors.front().iov_len) {
+                written -= vectors.front().iov_len;
+                vectors = vectors.subspan(1);
+            }
+            if (!vectors.empty()) {
+                vectors.front().iov_base = static_cast<char*>(vectors.front().iov_base) + written;
+                vectors.front().iov_len -= written;
+            }
+        }
+        written_ += total;
+        unsynced_ += total;
+        apply_sync_policy_();
+    }
+
+    void apply_sync_policy_() {
+        if (options_.sync == sync_policy::every_n_bytes && unsynced_ >= options_.sync_bytes) {
+            sync_();
+        } else if (options_.sync == sync_policy::group_commit && !options_.background_flush
+                   && std::chrono::steady_clock::now() - last_sync_ >= options_.sync_interval) {
+            sync_();
+        }
+    }
+
+    void sync_() {
+        if (error_ || fd_ < 0 || unsynced_ == 0) {
+            return;
+        }
+        if (::fdatasync(fd_) != 0) {
+            error_ = std::error_code(errno, std::generic_category());
+        }
+        unsynced_  = 0;
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+
+    void background_flush_(std::stop_token stop) {
+        std::unique_lock lock(mutex_);
+        while (!stop.stop_requested()) {
+            // the stop request notifies the condition itself: it can't be missed in between the check and the wait
+            std::ignore = wake_up_.wait_for(lock, stop, options_.sync_interval, [] { return false; });
+            flush_();
+            if (options_.sync == sync_policy::group_commit) {
+                sync_();
+            }
+        }
+    }
+
+    void set_direct_(bool direct) {
+        const int flags = ::fcntl(fd_, F_GETFL);
+        if (flags >= 0) {
+            ::fcntl(fd_, F_SETFL, direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT));
+        }
+        direct_ = direct;
+    }
+
+    [[nodiscard]] std::size_t file_size_() const {
+        struct stat file_stat {};
+        return ::fstat(fd_, &file_stat) == 0 ? static_cast<std::size_t>(file_stat.st_size) : 0;
+    }
+
+    [[nodiscard]] static constexpr bool is_aligned_(std::size_t value) { return value % WRITER_ALIGNMENT == 0; }
+
+  private:
+    std::filesystem::path file_path_;                           //!< path of the written file
+    writer_options options_;                                    //!< options of the writer
+    std::size_t capacity_;                                      //!< size of the buffer
+    std::unique_ptr<char[], details_::aligned_deleter> buffer_; //!< data not written yet (aligned for direct mode)
+    std::size_t size_ {0};                                      //!< size of the data in the buffer
+    int fd_ {-1};                                               //!< file descriptor, negative if the file isn't opened
+    bool direct_ {false};                                       //!< true if the file is opened with O_DIRECT
+    std::error_code error_;                                     //!< first I/O error that occurred
+
+    std::size_t written_ {0};                         //!< bytes written to the file
+    std::size_t unsynced_ {0};                        //!< bytes written since the last sync
+    std::chrono::steady_clock::time_point last_sync_; //!< time of the last sync
+
+    mutable std::mutex mutex_;            //!< protects the buffer from the background flush thread
+    std::condition_variable_any wake_up_; //!< waited by the background flush thread, interrupted by its stop request
+    std::jthread flusher_;                //!< background flush thread, if enabled
+};
+
+/**
+ * @brief copy the lines of a reader to a writer, through a transformation
+ * @param reader line reader (file_reader, mapped_file_reader...) to read the lines from
+ * @param writer writer of the output
+ * @param transform function called as `transform(std::string_view line, file_writer& writer)` on each line, writing its
+ * result into the writer (nothing to filter the line out)
+ * @return number of lines read
+ */
+template<meta::line_reader Reader, std::invocable<std::string_view, file_writer&> Transform>
+std::size_t transform_lines(Reader& reader, file_writer& writer, Transform&& transform) {
+    std::size_t lines = 0;
+    for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+        std::invoke(transform, line.get(), writer);
+        ++lines;
+    }
+    return lines;
+}
+
+/**
+ * @brief copy the lines of a reader to a writer
+ * @return number of lines copied
+ */
+template<meta::line_reader Reader>
+std::size_t copy_lines(Reader& reader, file_writer& writer) {
+    return transform_lines(reader, writer, [](std::string_view line, file_writer& out) { out.write_line(line); });
+}
+
+} // namespace fil
+
+#endif // FIL_FILE_WRITER_HH
@@ -0,0 +1,148 @@
+/// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FIL_MAPPED_FILE_HH
+#define FIL_MAPPED_FILE_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fil {
+
+/**
+ * @brief hint given to the kernel on the way a mapped file is going to be accessed, @see madvise(2)
+ */
+enum class access_advice : int {
+    normal     = MADV_NORMAL,     //!< no specific hint
+    sequential = MADV_SEQUENTIAL, //!< pages are read in order: aggressive read-ahead, pages freed soon after being read
+    random     = MADV_RANDOM,     //!< pages are read in random order: read-ahead is disabled
+    will_need  = MADV_WILLNEED,   //!< pages are going to be accessed soon: read-ahead of the range is started
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The content of the file is accessible as a view that stays valid for the whole lifetime of the instance. The mapping
+ * is released upon destruction of the object.
+ * @note an empty file is opened successfully but is not mapped (its view is empty)
+ */
+class mapped_file {
+  public:
+    explicit mapped_file(const std::filesystem::path& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) == 0) {
+            opened_ = true;
+            if (file_stat.st_size > 0) {
+                void* address = ::mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+                    data_ = static_cast<const char*>(address);
+                    size_ = static_cast<std::size_t>(file_stat.st_size);
+                } else {
+                    opened_ = false;
+                }
+            }
+        }
+        ::close(fd);
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , opened_(std::exchange(other.opened_, false)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            unmap_();
+            data_   = std::exchange(other.data_, nullptr);
+            size_   = std::exchange(other.size_, 0);
+            opened_ = std::exchange(other.opened_, false);
+        }
+        return *this;
+    }
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() { unmap_(); }
+
+    /**
+     * @return true if the file has been opened and mapped successfully
+     */
+    [[nodiscard]] bool is_open() const { return opened_; }
+
+    /**
+     * @return view on the whole content of the file
+     */
+    [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+
+    [[nodiscard]] const char* data() const { return data_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+    /**
+     * @brief give a hint to the kernel on the way a range of the mapping is going to be accessed
+     * @param advice access pattern of the range
+     * @param offset beginning of the range in the file (aligned down to the page it belongs to)
+     * @param length size of the range, up to the end of the file by default
+     * @return true if the hint has been taken into account, false otherwise (or if nothing is mapped)
+     */
+    bool advise(access_advice advice, std::size_t offset = 0, std::size_t length = std::string_view::npos) const {
+        if (data_ == nullptr || offset >= size_) {
+            return false;
+        }
+        static const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+        const std::size_t aligned_offset = offset - (offset % page_size);
+        const std::size_t aligned_length = std::min(length, size_ - offset) + (offset - aligned_offset);
+        return ::madvise(const_cast<char*>(data_) + aligned_offset, aligned_length, static_cast<int>(advice)) == 0;
+    }
+
+  private:
+    void unmap_() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+            data_ = nullptr;
+        }
+    }
+
+  private:
+    const char* data_ {nullptr}; //!< beginning of the mapping
+    std::size_t size_ {0};       //!< size of the mapping (size of the file)
+    bool opened_ {false};        //!< true if the file has been opened successfully
+};
+
+} // namespace fil
+
+#endif // FIL_MAPPED_FILE_HH
@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_MAPPED_FILE_READER_HH
+#define FIL_MAPPED_FILE_READER_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "fil/file/mapped_file.hh"
+#include "fil/meta/reader.hh"
+#include "fil/meta/shallow_copy.hh"
+
+namespace fil {
+
+/**
+ * @brief Reader of a file through a memory mapping of its whole content.
+ *
+ * @details Where @c fil::file_reader copies the file block per block into its own buffer (seeking backward to re-read
+ * the part of the block not consumed yet), the `mapped_file_reader` reads the pages of the file directly from the page
+ * cache: there is no copy and no reload.
+ *
+ * As the whole file is mapped, the blocks handed out by the reader stay valid for the lifetime of the reader (and of
+ * its shallow copies, which share the mapping). A shallow copy is a copy of the view on the mapping and of the cursor.
+ *
+ * @note the view on the content of shallow copies is valid as long as the reader they come from is alive.
+ */
+class mapped_file_reader {
+    template<typename>
+    friend struct shallow_copy;
+
+  public:
+    using checkpoint_type = std::size_t; //!< a checkpoint of a mapped_file_reader is its cursor
+
+    /**
+     * @brief block of text retrieved from the mapped_file_reader, valid for the lifetime of the reader
+     */
+    class block_view {
+      public:
+        block_view() = default;
+        explicit block_view(std::string_view block)
+            : block_(block)
+            , valid_(true) {}
+
+        /**
+         * @return true if the block has been retrieved successfully, false otherwise
+         */
+        [[nodiscard]] bool is_valid() const { return valid_; }
+
+        /**
+         * @return string view representing the block read from the file
+         */
+        [[nodiscard]] std::string_view get() const { return block_; }
+
+      private:
+        std::string_view block_ {}; //!< block retrieved from the mapping
+        bool valid_ {false};        //!< false if no block has been retrieved
+    };
+
+    /**
+     * @param file_path path of the file to read
+     * @param advice hint on the way the file is going to be read, sequential by default
+     */
+    explicit mapped_file_reader(std::filesystem::path file_path, access_advice advice = access_advice::sequential)
+        : file_path_(std::move(file_path))
+        , file_(std::in_place, file_path_)
+        , content_(file_->view()) {
+        file_->advise(advice);
+    }
+
+    mapped_file_reader(mapped_file_reader&&)            = default;
+    mapped_file_reader& operator=(mapped_file_reader&&) = default;
+
+    /**
+     * @brief give a hint to the kernel on the way a range of the file is going to be accessed
+     * @param advice access pattern of the range (@c access_advice::will_need to prefetch the range)
+     * @param offset beginning of the range, the cursor of the reader by default
+     * @param length size of the range, up to the end of the file by default
+     * @return true if the hint has been taken into account, false otherwise (always false for a shallow copy)
+     */
+    bool advise(access_advice advice, std::optional<std::size_t> offset = std::nullopt,
+                std::size_t length = std::string_view::npos) const {
+        return file_.has_value() && file_->advise(advice, offset.value_or(cursor_), length);
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> next_byte() {
+        if (cursor_ >= content_.size()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(content_[cursor_++]);
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> previous_byte() {
+        if (cursor_ == 0) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(content_[--cursor_]);
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> peek() const {
+        if (cursor_ >= content_.size()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(content_[cursor_]);
+    }
+
+    /**
+     * @brief read a specific line of the file, the cursor is set at the beginning of the next line
+     * @param line number of the line to read (starting at 1)
+     * @return block of the line (without the end of line character), invalid if the line doesn't exist
+     */
+    block_view read_line(std::size_t line) {
+        if (line == 0) {
+            return {};
+        }
+        cursor_ = 0;
+        for (std::size_t i = 1; i < line; ++i) {
+            const auto pos = content_.find('\n', cursor_);
+            if (pos == std::string_view::npos) {
+                cursor_ = content_.size();
+                return {};
+            }
+            cursor_ = pos + 1;
+        }
+        return next_line();
+    }
+
+    /**
+     * @return block of the line starting at the cursor (without the end of line character), invalid if the end of the
+     * file is reached
+     */
+    block_view next_line() {
+        if (cursor_ >= content_.size()) {
+            return {};
+        }
+        const auto start = cursor_;
+        const auto pos   = content_.find('\n', start);
+        const auto end   = pos == std::string_view::npos ? content_.size() : pos;
+
+        cursor_ = std::min(end + 1, content_.size());
+        return block_view {content_.substr(start, end - start)};
+    }
+
+    /**
+     * @brief Reads from the cursor until the predicate returns true for the accumulated string view.
+     * @return block read from the cursor up to when the predicate returned true, invalid block (and cursor unchanged)
+     * if the predicate never returned true before the end of the file
+     */
+    template<std::invocable<std::string_view> Predicate>
+    [[nodiscard]] block_view read_until(Predicate&& predicate) {
+        for (std::size_t end = cursor_ + 1; end <= content_.size(); ++end) {
+            const auto block = content_.substr(cursor_, end - cursor_);
+            if (std::invoke(predicate, block)) {
+                cursor_ = end;
+                return block_view {block};
+            }
+        }
+        return {};
+    }
+
+    /**
+     * @brief Reads from the cursor until the predicate returns true for a character (included in the block).
+     * @return block read from the cursor up to the character matching the predicate, invalid block (and cursor unchanged)
+     * if no character matched before the end of the file
+     */
+    template<std::invocable<char> Predicate>
+    [[nodiscard]] block_view read_until(Predicate&& predicate) {
+        const auto it = std::find_if(content_.begin() + cursor_, content_.end(), std::forward<Predicate>(predicate));
+        if (it == content_.end()) {
+            return {};
+        }
+        const auto start = cursor_;
+        cursor_          = static_cast<std::size_t>(std::distance(content_.begin(), it)) + 1;
+        return block_view {content_.substr(start, cursor_ - start)};
+    }
+
+    /**
+     * @return checkpoint of the current state of the reader, @see restore
+     */
+    [[nodiscard]] checkpoint_type checkpoint() const { return cursor_; }
+
+    /**
+     * @brief restore the reader at the state it had when the checkpoint was made
+     * @param checkpoint to restore the reader to
+     */
+    void restore(checkpoint_type checkpoint) { cursor_ = checkpoint; }
+
+    /**
+     * @return true if the file has been mapped successfully (always false for a shallow copy)
+     */
+    [[nodiscard]] bool is_open() const { return file_.has_value() && file_->is_open(); }
+
+    /**
+     * @return view on the whole content of the file
+     */
+    [[nodiscard]] std::string_view view() const { return content_; }
+
+    [[nodiscard]] const std::filesystem::path& get_path() const { return file_path_; }
+    [[nodiscard]] bool exists() const { return std::filesystem::exists(file_path_); }
+    [[nodiscard]] std::size_t reader_cursor() const { return cursor_; }
+    [[nodiscard]] std::size_t size() const { return content_.size(); }
+
+    /**
+     * @return true if the reader is the result of shallow_copy
+     */
+    [[nodiscard]] bool is_shallow_copy() const { return !file_.has_value(); }
+
+  private:
+    mapped_file_reader() = default;
+
+  private:
+    std::filesystem::path file_path_; //!< path to the file to read, not set for a shallow copy
+    std::optional<mapped_file> file_; //!< mapping of the file, not set for a shallow copy
+    std::string_view content_ {};     //!< view on the content of the mapping
+    std::size_t cursor_ {0};          //!< cursor in the file
+};
+
+static_assert(meta::bytes_reader<mapped_file_reader>, "mapped_file_reader must be a byte reader");
+static_assert(meta::line_reader<mapped_file_reader>, "mapped_file_reader must be a line reader");
+static_assert(meta::checkpoint_reader<mapped_file_reader>, "mapped_file_reader must be a checkpoint reader");
+
+/**
+ * @brief specialization of the shallow_copy, a copy of the view on the mapping and of the cursor.
+ */
+template<>
+struct shallow_copy<mapped_file_reader> {
+    static constexpr auto copy(const mapped_file_reader& object) {
+        mapped_file_reader shallow;
+        shallow.content_ = object.content_;
+        shallow.cursor_  = object.cursor_;
+        return shallow;
+    }
+
+    static constexpr auto assign(mapped_file_reader& object, mapped_file_reader&& other) { object.cursor_ = other.cursor_; }
+};
+
+} // namespace fil
+
+#endif // FIL_MAPPED_FILE_READER_HH
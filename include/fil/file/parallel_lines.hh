@@ -0,0 +1,254 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_PARALLEL_LINES_HH
+#define FIL_PARALLEL_LINES_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "fil/algorithm/line_scan.hh"
+#include "fil/file/mapped_file.hh"
+
+namespace fil {
+
+static constexpr std::size_t PARALLEL_CHUNK_SIZE = 16 * 1024 * 1024; //!< default size of the chunks processed in parallel (16Mb)
+
+namespace details_ {
+
+template<typename Fn>
+void for_each_line(std::string_view content, Fn&& fn) {
+    const char* it  = content.data();
+    const char* end = it + content.size();
+    while (it < end) {
+        const char* newline = find_newline(it, end);
+        std::invoke(fn, std::string_view(it, static_cast<std::size_t>(newline - it)));
+        it = newline + 1;
+    }
+}
+
+} // namespace details_
+
+/**
+ * @brief range of a file processed by a worker, starting at the beginning of a line and ending after an end of line
+ * (or at the end of the file)
+ */
+struct file_chunk {
+    std::size_t index;        //!< index of the chunk in the file (chunks are ordered by offset)
+    std::size_t offset;       //!< offset of the beginning of the chunk in the file
+    std::string_view content; //!< content of the chunk, valid for the duration of the processing
+};
+
+/**
+ * @brief executor running `task_count` tasks (`task(index)` for each index in [0, task_count)), returning when all the
+ * tasks are completed
+ */
+template<typename T>
+concept chunk_executor = requires(T& executor, std::size_t task_count, const std::function<void(std::size_t)>& task) {
+    executor(task_count, task);
+};
+
+/**
+ * @brief default executor of the parallel processing: a pool of threads created for the processing, taking the next task
+ * to run from a shared counter (a worker done with a short chunk takes the next one instead of waiting for the others)
+ *
+ * @details The first exception thrown by a task stops the distribution of the remaining tasks and is re-thrown once
+ * all the workers are joined.
+ */
+struct thread_executor {
+    std::size_t workers = std::max(1u, std::thread::hardware_concurrency()); //!< number of threads used
+
+    void operator()(std::size_t task_count, const std::function<void(std::size_t)>& task) const {
+        std::atomic<std::size_t> next {0};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        const auto work = [&] {
+            for (std::size_t index = next++; index < task_count; index = next++) {
+                try {
+                    task(index);
+                } catch (...) {
+                    std::scoped_lock lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    next = task_count;
+                }
+            }
+        };
+        {
+            std::vector<std::jthread> threads;
+            const auto thread_count = std::min(std::max<std::size_t>(workers, 1), task_count);
+            for (std::size_t i = 1; i < thread_count; ++i) {
+                threads.emplace_back(work);
+            }
+            work(); // the calling thread is a worker as well
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+/**
+ * @brief split a content into chunks of about `chunk_size` bytes, each chunk (except the first one) starting right
+ * after an end of line
+ * @param content to split
+ * @param chunk_size targeted size of a chunk, a chunk can be bigger if its last line overlaps the next chunk
+ * @return offsets of the beginning of each chunk, followed by the size of the content (the end of the last chunk)
+ */
+[[nodiscard]] inline std::vector<std::size_t> split_on_lines(std::string_view content, std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+    std::vector<std::size_t> bounds {0};
+    const char* begin = content.data();
+    const char* end   = begin + content.size();
+    while (content.size() - bounds.back() > chunk_size) {
+        const char* newline = find_newline(begin + bounds.back() + chunk_size - 1, end);
+        if (newline == end) {
+            break;
+        }
+        bounds.push_back(static_cast<std::size_t>(newline - begin) + 1);
+    }
+    if (bounds.back() != content.size()) {
+        bounds.push_back(content.size());
+    }
+    return bounds;
+}
+
+/**
+ * @brief process the chunks of a file in parallel, each chunk starting at the beginning of a line
+ *
+ * @details The file is memory mapped (every worker reads its own range of the mapping, there is no shared stream) and
+ * split in chunks of about `chunk_size` bytes aligned on the end of lines. The function is called concurrently on
+ * different chunks: it has to be thread-safe.
+ *
+ * @param path of the file to process
+ * @param fn function called on each chunk (@c file_chunk), its results are returned in the order of the chunks
+ * @param executor executor running the processing of the chunks, a pool of `hardware_concurrency` threads by default
+ * @param chunk_size targeted size of a chunk
+ * @return results of the function for each chunk, ordered as the chunks in the file (nothing if the function returns void)
+ * @throw std::runtime_error if the file cannot be mapped
+ */
+template<std::invocable<const file_chunk&> Fn, chunk_executor Executor = thread_executor>
+auto parallel_for_each_chunk(const std::filesystem::path& path, Fn&& fn, Executor&& executor = {},
+                             std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    using result_type = std::invoke_result_t<Fn&, const file_chunk&>;
+
+    const mapped_file file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Could not open file for reading: {}", path.string()));
+    }
+    file.advise(access_advice::sequential);
+
+    const auto content = file.view();
+    const auto bounds  = split_on_lines(content, chunk_size);
+    const auto chunks  = bounds.size() - 1;
+
+    const auto make_chunk = [&](std::size_t index) {
+        return file_chunk {
+            .index   = index,
+            .offset  = bounds[index],
+            .content = content.substr(bounds[index], bounds[index + 1] - bounds[index]),
+        };
+    };
+
+    if constexpr (std::is_void_v<result_type>) {
+        executor(chunks, [&](std::size_t index) { std::invoke(fn, make_chunk(index)); });
+    } else {
+        std::vector<std::optional<result_type>> results(chunks);
+        executor(chunks, [&](std::size_t index) { results[index].emplace(std::invoke(fn, make_chunk(index))); });
+
+        std::vector<result_type> ordered;
+        ordered.reserve(chunks);
+        for (auto& result : results) {
+            ordered.push_back(std::move(result.value()));
+        }
+        return ordered;
+    }
+}
+
+/**
+ * @brief call a function on each line of a file, the lines being processed in parallel (in no particular order)
+ * @param path of the file to process
+ * @param fn thread-safe function called on each line (without its end of line character)
+ * @param executor executor running the processing of the chunks, a pool of `hardware_concurrency` threads by default
+ * @param chunk_size targeted size of the chunks of lines processed by a worker at once
+ * @throw std::runtime_error if the file cannot be mapped
+ */
+template<std::invocable<std::string_view> Fn, chunk_executor Executor = thread_executor>
+void parallel_for_each_line(const std::filesystem::path& path, Fn&& fn, Executor&& executor = {},
+                            std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    parallel_for_each_chunk(
+        path,
+        [&fn](const file_chunk& chunk) { details_::for_each_line(chunk.content, fn); },
+        std::forward<Executor>(executor), chunk_size);
+}
+
+/**
+ * @brief reduce the lines of a file in parallel: each chunk is reduced independently from `init`, then the results of
+ * the chunks are combined in the order of the file
+ * @param path of the file to process
+ * @param init initial value of the reduction of each chunk (and of the combination of the chunks)
+ * @param accumulate function called as `accumulate(T& accumulator, std::string_view line)` on each line of a chunk
+ * @param combine function called as `combine(T accumulated, T chunk_result) -> T` in the order of the chunks
+ * @param executor executor running the processing of the chunks, a pool of `hardware_concurrency` threads by default
+ * @param chunk_size targeted size of the chunks of lines processed by a worker at once
+ * @return combination of the results of all the chunks
+ * @throw std::runtime_error if the file cannot be mapped
+ */
+template<typename T, typename Accumulate, typename Combine, chunk_executor Executor = thread_executor>
+requires std::invocable<Accumulate&, T&, std::string_view> && std::is_invocable_r_v<T, Combine&, T, T>
+[[nodiscard]] T parallel_reduce_lines(const std::filesystem::path& path, T init, Accumulate&& accumulate, Combine&& combine,
+                                      Executor&& executor = {}, std::size_t chunk_size = PARALLEL_CHUNK_SIZE) {
+    auto results = parallel_for_each_chunk(
+        path,
+        [&init, &accumulate](const file_chunk& chunk) {
+            T accumulator = init;
+            details_::for_each_line(chunk.content, [&](std::string_view line) { std::invoke(accumulate, accumulator, line); });
+            return accumulator;
+        },
+        std::forward<Executor>(executor), chunk_size);
+
+    T accumulated = std::move(init);
+    for (auto& chunk_result : results) {
+        accumulated = std::invoke(combine, std::move(accumulated), std::move(chunk_result));
+    }
+    return accumulated;
+}
+
+} // namespace fil
+
+#endif // FIL_PARALLEL_LINES_HH
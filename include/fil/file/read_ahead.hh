@@ -0,0 +1,210 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_READ_AHEAD_HH
+#define FIL_READ_AHEAD_HH
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "fil/file/buffer_pool.hh"
+#include "fil/file/file_handle.hh"
+
+namespace fil {
+
+/**
+ * @brief option of a reader to read the next blocks of the file in advance, in a background thread
+ */
+struct read_ahead_mode {
+    std::size_t in_flight = 2; //!< number of blocks read in advance (each block being a buffer of the size of the reader buffer)
+};
+
+namespace details_ {
+
+/**
+ * @brief background reader filling a queue of consecutive blocks of a file
+ *
+ * @details The worker reads the blocks following the last one taken by the consumer, as long as a buffer is free (at
+ * most `in_flight` blocks are read in advance). The consumer takes the block starting at the position it needs: if it
+ * is the next block of the queue, its buffer is swapped with the buffer of the consumer (no copy), waiting for the read
+ * to complete if it is still in progress. Otherwise, the consumer reads by itself and re-starts the read ahead from the
+ * position following its read.
+ *
+ * The data of a block is read after `headroom` bytes left free at the beginning of the buffer (where the consumer can
+ * copy data in front of the block), and is followed by an extra byte for null-termination. The buffers are borrowed
+ * from the buffer pool of the consumer.
+ */
+class read_ahead_worker {
+    struct block {
+        pooled_buffer buffer;
+        std::size_t position {0}; //!< position in the file of the beginning of the block
+        std::size_t size {0};     //!< number of bytes read in the buffer
+    };
+
+  public:
+    read_ahead_worker(std::shared_ptr<const file_handle> file, std::size_t in_flight, std::size_t block_size, std::size_t headroom = 0,
+                      std::shared_ptr<buffer_pool> pool = buffer_pool::global())
+        : file_(std::move(file))
+        , pool_(std::move(pool))
+        , block_size_(block_size)
+        , headroom_(headroom) {
+        for (std::size_t i = 0; i < std::max<std::size_t>(in_flight, 1); ++i) {
+            free_.push_back(pool_->acquire(buffer_capacity_()));
+        }
+        worker_ = std::jthread([this](std::stop_token stop) { run_(stop); });
+    }
+
+    read_ahead_worker(const read_ahead_worker&)            = delete;
+    read_ahead_worker& operator=(const read_ahead_worker&) = delete;
+
+    ~read_ahead_worker() {
+        worker_.request_stop();
+        condition_.notify_all();
+    }
+
+    /**
+     * @brief take the block starting at the provided position if it is the next block read ahead
+     * @param position position in the file of the block requested
+     * @param buffer buffer of the consumer, swapped with the buffer of the block (the previous buffer is re-used by the
+     *               worker), the data of the block starts after the headroom
+     * @param size set with the number of bytes read in the block
+     * @return true if the block has been taken, false if the block isn't the next one read ahead (the consumer has to read it)
+     */
+    bool take(std::size_t position, pooled_buffer& buffer, std::size_t& size) {
+        std::unique_lock lock(mutex_);
+        if (position != next_position_) {
+            return false;
+        }
+        condition_.wait(lock, [this] { return !ready_.empty() || (end_of_file_ && !reading_) || failed_; });
+        if (ready_.empty()) {
+            if (failed_) {
+                return false;
+            }
+            size = 0; // end of the file
+            return true;
+        }
+
+        auto& front = ready_.front();
+        std::swap(buffer, front.buffer);
+        free_.push_back(std::move(front.buffer)); // borrowed again by the worker if empty or too small
+        size = front.size;
+        next_position_ += front.size;
+        ready_.pop_front();
+
+        lock.unlock();
+        condition_.notify_all();
+        return true;
+    }
+
+    /**
+     * @brief discard the blocks read ahead and start reading ahead from the provided position
+     */
+    void restart(std::size_t position) {
+        {
+            std::scoped_lock lock(mutex_);
+            for (auto& b : ready_) {
+                free_.push_back(std::move(b.buffer));
+            }
+            ready_.clear();
+            ++generation_;
+            next_position_ = position;
+            read_position_ = position;
+            end_of_file_   = false;
+            failed_        = false;
+        }
+        condition_.notify_all();
+    }
+
+  private:
+    void run_(std::stop_token stop) {
+        while (!stop.stop_requested()) {
+            std::unique_lock lock(mutex_);
+            condition_.wait(lock, stop, [this] { return !free_.empty() && !end_of_file_ && !failed_; });
+            if (stop.stop_requested()) {
+                return;
+            }
+
+            block b {.buffer = std::move(free_.back()), .position = read_position_};
+            free_.pop_back();
+            const auto generation = generation_;
+            reading_              = true;
+            lock.unlock();
+
+            if (b.buffer.size() < buffer_capacity_()) {
+                b.buffer = pool_->acquire(buffer_capacity_());
+            }
+            const auto read  = file_->read_at(b.buffer.data() + headroom_, block_size_, b.position);
+            b.size           = read.value_or(0);
+            const bool error = !read.has_value();
+
+            lock.lock();
+            reading_ = false;
+            if (generation != generation_) {
+                free_.push_back(std::move(b.buffer)); // restarted while reading: the block is discarded
+            } else if (error) {
+                failed_ = true;
+                free_.push_back(std::move(b.buffer));
+            } else {
+                end_of_file_ = b.size < block_size_;
+                read_position_ += b.size;
+                ready_.push_back(std::move(b));
+            }
+            lock.unlock();
+            condition_.notify_all();
+        }
+    }
+
+    [[nodiscard]] std::size_t buffer_capacity_() const { return headroom_ + block_size_ + 2; }
+
+  private:
+    std::shared_ptr<const file_handle> file_; //!< file read (shared with the consumer, reads are positional)
+    std::shared_ptr<buffer_pool> pool_;       //!< pool the buffers are borrowed from
+    std::size_t block_size_;                  //!< number of bytes read per block
+    std::size_t headroom_;                    //!< number of bytes left free in front of the data of a block
+
+    std::mutex mutex_;                      //!< protect the state below
+    std::condition_variable_any condition_; //!< notified on each change of the state
+    std::deque<block> ready_;               //!< blocks read ahead, in order
+    std::vector<pooled_buffer> free_;       //!< buffers available for the worker to read into
+    std::size_t next_position_ {0};         //!< position of the next block the consumer is expected to take
+    std::size_t read_position_ {0};         //!< position of the next block the worker reads
+    std::size_t generation_ {0};            //!< incremented at each restart, discard the read in progress
+    bool reading_ {false};                  //!< true while the worker is reading a block
+    bool end_of_file_ {false};              //!< true if the end of the file has been read
+    bool failed_ {false};                   //!< true if a read failed, the consumer reads by itself
+
+    std::jthread worker_; //!< background thread, declared last to be stopped and joined first
+};
+
+} // namespace details_
+
+} // namespace fil
+
+#endif // FIL_READ_AHEAD_HH
@@ -0,0 +1,338 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_SHARDED_READER_HH
+#define FIL_SHARDED_READER_HH
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "fil/file/file_reader.hh"
+#include "fil/meta/reader.hh"
+
+namespace fil {
+
+/**
+ * @brief options of a @c sharded_reader
+ */
+struct sharded_options {
+    std::size_t prefetch = 2;     //!< number of shards opened and loaded in advance by the background thread
+    bool order_by_size   = false; //!< read the biggest shards first (load balancing of parallel consumers), in order otherwise
+    reader_options reader {};     //!< options of the reader of each shard
+};
+
+namespace details_ {
+
+/**
+ * @param pattern containing `*` (any sequence of characters) and `?` (any character) wildcards
+ * @param name to match
+ * @return true if the whole name matches the pattern
+ */
+[[nodiscard]] inline bool match_wildcard(std::string_view pattern, std::string_view name) {
+    std::size_t p      = 0;
+    std::size_t n      = 0;
+    std::size_t star   = std::string_view::npos; // position of the last star of the pattern met
+    std::size_t resume = 0;                      // position of the name matched by the last star met
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star   = p++;
+            resume = n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1; // the last star matches one more character
+            n = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+/**
+ * @brief Background thread opening the shards in order, and loading their first block, ahead of their consumers.
+ *
+ * @details Up to `prefetch` shards are kept ready: the thread waits for a shard to be taken to open the next one.
+ */
+class shard_prefetcher {
+  public:
+    shard_prefetcher(std::vector<std::filesystem::path> paths, std::size_t prefetch, reader_options options)
+        : paths_(std::move(paths))
+        , prefetch_(std::max<std::size_t>(prefetch, 1))
+        , options_(std::move(options)) {
+        worker_ = std::jthread([this](std::stop_token stop) { run_(stop); });
+    }
+
+    shard_prefetcher(const shard_prefetcher&)            = delete;
+    shard_prefetcher& operator=(const shard_prefetcher&) = delete;
+
+    ~shard_prefetcher() {
+        worker_.request_stop();
+        condition_.notify_all();
+    }
+
+    /**
+     * @brief take the next shard, waiting for it to be opened if it isn't ready yet (thread-safe)
+     * @return reader of the next shard, nullopt if all the shards have been taken
+     */
+    [[nodiscard]] std::optional<file_reader> next() {
+        std::unique_lock lock(mutex_);
+        if (taken_ == paths_.size()) {
+            return std::nullopt;
+        }
+        const auto index = taken_++;
+        condition_.wait(lock, [this, index] { return opened_ > index; });
+        auto reader = std::move(ready_.front());
+        ready_.pop_front();
+        lock.unlock();
+        condition_.notify_all();
+        return reader;
+    }
+
+    [[nodiscard]] std::size_t size() const { return paths_.size(); }
+
+  private:
+    void run_(std::stop_token stop) {
+        for (std::size_t index = 0; index < paths_.size(); ++index) {
+            {
+                std::unique_lock lock(mutex_);
+                if (!condition_.wait(lock, stop, [this] { return ready_.size() < prefetch_; })) {
+                    return;
+                }
+            }
+            file_reader reader(paths_[index], options_);
+            std::ignore = reader.prefetch();
+            {
+                std::scoped_lock lock(mutex_);
+                ready_.push_back(std::move(reader));
+                ++opened_;
+            }
+            condition_.notify_all();
+        }
+    }
+
+  private:
+    std::vector<std::filesystem::path> paths_; //!< shards, in the order they are read
+    std::size_t prefetch_;                     //!< maximum number of shards ready
+    reader_options options_;                   //!< options of the reader of each shard
+
+    std::mutex mutex_;                      //!< protect the state below
+    std::condition_variable_any condition_; //!< notified on each change of the state
+    std::deque<file_reader> ready_;         //!< shards opened and not taken yet, in order
+    std::size_t opened_ {0};                //!< number of shards opened
+    std::size_t taken_ {0};                 //!< number of shards taken (or being waited for) by the consumers
+
+    std::jthread worker_; //!< thread opening the shards (last member: started once the state is constructed)
+};
+
+} // namespace details_
+
+/**
+ * @brief list the files matching a pattern, to be read as shards
+ * @param pattern path whose file name can contain `*` (any sequence of characters) and `?` (any character) wildcards,
+ * e.g. `dataset/part-*.csv` (the directories can't)
+ * @return regular files of the directory of the pattern matching it, in lexicographic order
+ */
+[[nodiscard]] inline std::vector<std::filesystem::path> glob_shards(const std::filesystem::path& pattern) {
+    const auto directory = pattern.has_parent_path() ? pattern.parent_path() : std::filesystem::path(".");
+    const auto name      = pattern.filename().string();
+
+    std::vector<std::filesystem::path> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.is_regular_file(error) && details_::match_wildcard(name, entry.path().filename().string())) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+    return paths;
+}
+
+/**
+ * @brief Reader of a dataset split into many files (shards), read as a single stream of lines and bytes.
+ *
+ * @details The shards are opened, and their first block loaded, by a background thread `prefetch` shards ahead of the
+ * shard read: the cold open and the first read of a shard overlap the processing of the previous ones. Each shard is
+ * read by a @c file_reader, the lines of a shard are followed by the lines of the next one (a last line without end of
+ * line isn't joined with the first line of the next shard). A shard that can't be opened is read as an empty file.
+ *
+ * For parallel consumers, the shards are taken one by one with @c next_shard (thread-safe): each consumer reads its
+ * shard with its own @c file_reader. A reader is used either as a stream or as a source of shards, not both.
+ */
+class sharded_reader {
+  public:
+    using block_view = file_reader::block_view;
+
+    explicit sharded_reader(std::vector<std::filesystem::path> paths, sharded_options options = {}) {
+        if (options.order_by_size) {
+            std::vector<std::pair<std::uintmax_t, std::filesystem::path>> sized;
+            sized.reserve(paths.size());
+            for (auto& path : paths) {
+                std::error_code error;
+                const auto size = std::filesystem::file_size(path, error);
+                sized.emplace_back(error ? 0 : size, std::move(path));
+            }
+            std::ranges::stable_sort(sized, std::greater {}, &decltype(sized)::value_type::first);
+            for (std::size_t i = 0; i < sized.size(); ++i) {
+                paths[i] = std::move(sized[i].second);
+            }
+        }
+        prefetcher_ = std::make_unique<details_::shard_prefetcher>(std::move(paths), options.prefetch, std::move(options.reader));
+    }
+
+    /**
+     * @brief take the next shard to read, for parallel consumers (thread-safe)
+     * @return reader of the next shard (opened, its first block loaded if it was prefetched), nullopt if all the shards
+     * have been taken
+     */
+    [[nodiscard]] std::optional<file_reader> next_shard() { return prefetcher_->next(); }
+
+    /**
+     * @return number of shards of the dataset
+     */
+    [[nodiscard]] std::size_t shard_count() const { return prefetcher_->size(); }
+
+    /**
+     * @return path of the shard currently read, empty if none is
+     */
+    [[nodiscard]] std::filesystem::path current_path() const {
+        return current_.has_value() ? current_->get_path() : std::filesystem::path {};
+    }
+
+    /**
+     * @return next line of the stream (valid until the next load of the current shard), invalid at the end of the last shard
+     */
+    [[nodiscard]] block_view next_line() {
+        while (current_shard_()) {
+            auto line = current_->next_line();
+            if (line.is_valid()) {
+                ++line_number_;
+                return line;
+            }
+            end_of_shard_();
+        }
+        return {};
+    }
+
+    /**
+     * @brief retrieve the line of the provided number, counted from the beginning of the stream (starting from 1)
+     * @details the shards are read forward only: the lines preceding the cursor can't be retrieved anymore (an invalid
+     * line is returned). The lines are counted by @c next_line and @c read_line only.
+     * @param line_nb number of the line to retrieve
+     * @return line retrieved, invalid if the stream has less lines or if the line has already been read
+     */
+    [[nodiscard]] block_view read_line(std::size_t line_nb) {
+        if (line_nb <= line_number_) {
+            return {};
+        }
+        while (line_number_ + 1 < line_nb) {
+            if (!next_line().is_valid()) {
+                return {};
+            }
+        }
+        return next_line();
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> next_byte() {
+        while (current_shard_()) {
+            if (const auto byte = current_->next_byte()) {
+                return byte;
+            }
+            end_of_shard_();
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @note the cursor doesn't move backward to the previous shard
+     * @return the character preceding the cursor in the current shard, if any
+     */
+    [[nodiscard]] std::optional<std::uint8_t> previous_byte() { return current_.has_value() ? current_->previous_byte() : std::nullopt; }
+
+    [[nodiscard]] std::optional<std::uint8_t> peek() {
+        while (current_shard_()) {
+            if (const auto byte = current_->next_byte()) {
+                std::ignore = current_->previous_byte();
+                return byte;
+            }
+            end_of_shard_();
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @return position of the cursor in the stream (sum of the sizes of the shards read and position in the current one)
+     */
+    [[nodiscard]] std::size_t reader_cursor() const {
+        return offset_ + (current_.has_value() ? current_->checkpoint().file_position : 0);
+    }
+
+  private:
+    /**
+     * @return true if a shard is being read (the next shard is taken if the previous one has been read entirely)
+     */
+    bool current_shard_() {
+        if (!current_.has_value()) {
+            current_ = prefetcher_->next();
+        }
+        return current_.has_value();
+    }
+
+    void end_of_shard_() {
+        offset_ += current_->size();
+        current_.reset();
+    }
+
+  private:
+    std::unique_ptr<details_::shard_prefetcher> prefetcher_; //!< background opening of the shards
+    std::optional<file_reader> current_;                     //!< reader of the shard currently read
+    std::size_t offset_ {0};                                 //!< size of the shards read entirely
+    std::size_t line_number_ {0};                            //!< number of lines retrieved
+};
+
+static_assert(meta::bytes_reader<sharded_reader>, "sharded_reader must be a byte reader");
+static_assert(meta::line_reader<sharded_reader>, "sharded_reader must be a line reader");
+
+} // namespace fil
+
+#endif // FIL_SHARDED_READER_HH
@@ -24,9 +24,26 @@
 #ifndef FIL_TEMPORARY_HH
 #define FIL_TEMPORARY_HH
 
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <format>
+#include <fstream>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <unistd.h>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#endif
 
 namespace fil {
 
@@ -38,14 +55,16 @@ class temporary_file {
   public:
     explicit temporary_file(const std::string& content, const std::string& prefix = "temp_file", const std::string& extension = ".txt")
         : path_([&] {
-            // Generate a unique filename
+            // Generate a unique filename: the file is created only if it doesn't exist yet, another name is tried otherwise
             std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(1000, 9999);
+            std::mt19937_64 gen((static_cast<std::uint64_t>(rd()) << 32) ^ rd());
 
-            const auto filename  = std::format("{}_{}{}", prefix, dis(gen), extension);
-            const auto temp_path = std::filesystem::temp_directory_path() / filename;
-            std::ofstream file(temp_path);
+            std::filesystem::path temp_path;
+            std::ofstream file;
+            for (int attempt = 0; attempt < 16 && !file.is_open(); ++attempt) {
+                temp_path = std::filesystem::temp_directory_path() / std::format("{}_{:016x}{}", prefix, gen(), extension);
+                file.open(temp_path, std::ios::out | std::ios::noreplace);
+            }
             if (!file) {
                 throw std::runtime_error(std::format("Could not open file for writing: {}", temp_path.string()));
             }
@@ -65,6 +84,179 @@ class temporary_file {
   private:
     std::filesystem::path path_;
 };
+
+/**
+ * @brief Temporary file held in memory, for I/O-free fixtures and benchmarks of the readers.
+ *
+ * @details The file is created with `memfd_create` and exposed through its `/proc/self/fd/<fd>` path, which can be
+ * opened by any reader as a regular file. If memfd isn't available (other OS, syscall filtered...), the file is created
+ * with a unique name on tmpfs (`/dev/shm`, the temporary folder of the OS if it doesn't exist) and exposed by its path.
+ * The content is appended with positional writes, synthetic content is generated in bulk by @c append_lines. The file
+ * is released upon destruction of the object.
+ */
+class memory_file {
+    static constexpr std::size_t GENERATION_CHUNK = 1024 * 1024; //!< size of the writes of the generated content (1Mb)
+
+  public:
+    explicit memory_file(std::string_view content = {}, const std::string& name = "fil_memory_file") {
+#if defined(MFD_CLOEXEC)
+        fd_ = ::memfd_create(name.c_str(), MFD_CLOEXEC);
+        if (fd_ >= 0) {
+            path_ = std::format("/proc/self/fd/{}", fd_);
+        }
+#endif
+        if (fd_ < 0) {
+            std::error_code ec;
+            const auto directory = std::filesystem::is_directory("/dev/shm", ec) ? std::filesystem::path("/dev/shm")
+                                                                                 : std::filesystem::temp_directory_path();
+            std::string file_template = (directory / (name + "_XXXXXX")).string();
+            fd_                       = ::mkstemp(file_template.data());
+            if (fd_ < 0) {
+                throw std::runtime_error(std::format("Could not create memory file: {}", file_template));
+            }
+            path_  = file_template;
+            named_ = true;
+        }
+        append(content);
+    }
+
+    ~memory_file() { release_(); }
+
+    memory_file(const memory_file&)            = delete;
+    memory_file& operator=(const memory_file&) = delete;
+
+    memory_file(memory_file&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , named_(other.named_)
+        , size_(other.size_)
+        , path_(std::move(other.path_)) {}
+
+    memory_file& operator=(memory_file&& other) noexcept {
+        if (this != &other) {
+            release_();
+            fd_    = std::exchange(other.fd_, -1);
+            named_ = other.named_;
+            size_  = other.size_;
+            path_  = std::move(other.path_);
+        }
+        return *this;
+    }
+
+    operator std::filesystem::path() const { return path_; }
+
+    /**
+     * @return path to open the file with (`/proc/self/fd/<fd>` for a memfd), valid as long as the object is alive
+     */
+    [[nodiscard]] const std::filesystem::path& path() const { return path_; }
+
+    /**
+     * @return file descriptor of the file
+     */
+    [[nodiscard]] int descriptor() const { return fd_; }
+
+    /**
+     * @return true if the file is a memfd, false if it is a named file (on tmpfs if available)
+     */
+    [[nodiscard]] bool is_memfd() const { return fd_ >= 0 && !named_; }
+
+    /**
+     * @return size of the file in bytes
+     */
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+    /**
+     * @brief resize the file: the extension is sparse (a hole read as zeros, no memory used until written), the following
+     * appends are written after it
+     * @param size new size of the file in bytes
+     */
+    void resize(std::size_t size) {
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            throw std::runtime_error(std::format("Could not resize memory file {} to {} bytes", path_.string(), size));
+        }
+        size_ = size;
+    }
+
+    /**
+     * @brief append content at the end of the file
+     */
+    void append(std::string_view content) {
+        std::size_t written = 0;
+        while (written < content.size()) {
+            const auto result = ::pwrite(fd_, content.data() + written, content.size() - written, static_cast<off_t>(size_ + written));
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::format("Error writing to memory file: {}", path_.string()));
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        size_ += written;
+    }
+
+    /**
+     * @brief append synthetic lines of a fixed length, generated in bulk
+     * @param count number of lines to append
+     * @param length number of characters of each line (not counting its end of line)
+     * @param fill character the lines are made of
+     */
+    void append_lines(std::size_t count, std::size_t length, char fill = 'x') {
+        const auto lines_per_chunk = std::max<std::size_t>(1, GENERATION_CHUNK / (length + 1));
+        std::string chunk;
+        chunk.reserve(std::min(count, lines_per_chunk) * (length + 1));
+        for (std::size_t i = 0; i < std::min(count, lines_per_chunk); ++i) {
+            chunk.append(length, fill);
+            chunk.push_back('\n');
+        }
+        // the chunk is generated once, and written as many times as needed
+        for (std::size_t remaining = count; remaining > 0;) {
+            const auto lines = std::min(remaining, lines_per_chunk);
+            append(std::string_view(chunk).substr(0, lines * (length + 1)));
+            remaining -= lines;
+        }
+    }
+
+    /**
+     * @brief append generated lines, buffered and written in bulk
+     * @param count number of lines to append
+     * @param generator called with the index of each line (starting from 0), returning its content (without end of line)
+     */
+    template<typename Generator>
+        requires std::invocable<Generator&, std::size_t>
+    void append_lines(std::size_t count, Generator&& generator) {
+        std::string chunk;
+        chunk.reserve(GENERATION_CHUNK);
+        for (std::size_t i = 0; i < count; ++i) {
+            chunk += generator(i);
+            chunk.push_back('\n');
+            if (chunk.size() >= GENERATION_CHUNK) {
+                append(chunk);
+                chunk.clear();
+            }
+        }
+        append(chunk);
+    }
+
+  private:
+    void release_() {
+        if (fd_ < 0) {
+            return;
+        }
+        ::close(fd_);
+        fd_ = -1;
+        if (named_) {
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+    }
+
+  private:
+    int fd_ {-1};                //!< file descriptor of the file, negative once released
+    bool named_ {false};         //!< true if the file is a named file (memfd not available), removed on release
+    std::size_t size_ {0};       //!< size of the file, where the next append is written
+    std::filesystem::path path_; //!< path to open the file with
+};
+
 } // namespace fil
 
 #endif // FIL_TEMPORARY_HH
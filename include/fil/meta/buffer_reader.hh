@@ -24,16 +24,83 @@
 #ifndef FIL_BUFFER_READER_HH
 #define FIL_BUFFER_READER_HH
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
+#include "fil/algorithm/line_scan.hh"
+#include "fil/meta/line_index.hh"
 #include "fil/meta/reader.hh"
+#include "fil/meta/reader_stats.hh"
 #include "fil/meta/shallow_copy.hh"
 
 namespace fil {
 
+namespace details_ {
+
+// Line scanning of an in-memory buffer from a cursor, shared by buffer_reader and buffer_view_reader.
+
+/**
+ * @brief move a cursor past the next lines of a buffer
+ * @param buffer scanned
+ * @param cursor position of the beginning of the first line to skip, moved at the beginning of the line following the
+ * skipped lines (at the end of the buffer if it has less lines)
+ * @param count number of lines to skip
+ */
+inline void skip_buffer_lines(std::string_view buffer, std::size_t& cursor, std::size_t count) {
+    const char* end = buffer.data() + buffer.size();
+    for (; count > 0 && cursor < buffer.size(); --count) {
+        const char* found = find_newline(buffer.data() + cursor, end);
+        cursor            = static_cast<std::size_t>(found - buffer.data()) + (found != end ? 1 : 0);
+    }
+}
+
+/**
+ * @param buffer scanned
+ * @param cursor position of the beginning of the line, moved past its end of line
+ * @return line at the cursor (without its end of line character), empty at the end of the buffer
+ */
+inline std::string_view next_buffer_line(std::string_view buffer, std::size_t& cursor) {
+    const std::size_t cursor_begin = std::min(cursor, buffer.size());
+    const char* end                = buffer.data() + buffer.size();
+    const char* found              = find_newline(buffer.data() + cursor_begin, end);
+    const auto cursor_end          = static_cast<std::size_t>(found - buffer.data());
+
+    cursor = cursor_end + (found != end ? 1 : 0);
+    return buffer.substr(cursor_begin, cursor_end - cursor_begin);
+}
+
+/**
+ * @param buffer scanned
+ * @param cursor moved past the end of line of the line retrieved (at the end of the buffer if it has less lines)
+ * @param line_nb number of the line to read (starting from 1)
+ * @return the line, empty if the buffer has less lines
+ */
+inline std::string_view read_buffer_line(std::string_view buffer, std::size_t& cursor, std::size_t line_nb) {
+    cursor = line_nb == 0 ? buffer.size() : 0;
+    skip_buffer_lines(buffer, cursor, line_nb == 0 ? 0 : line_nb - 1);
+    return next_buffer_line(buffer, cursor);
+}
+
+/**
+ * @param buffer scanned
+ * @param cursor position of the beginning of the first line, moved past the end of line of the last line filled
+ * @param lines filled with the next lines (without the end of line character), up to its size
+ * @return number of lines filled, 0 if the end of the buffer is reached
+ */
+inline std::size_t next_buffer_lines(std::string_view buffer, std::size_t& cursor, std::span<std::string_view> lines) {
+    const auto [filled, consumed] = split_lines(buffer.substr(std::min(cursor, buffer.size())), lines);
+    cursor += consumed;
+    return filled;
+}
+
+} // namespace details_
+
 /**
  * @class buffer_reader
  * @brief A class for sequentially reading and accessing data from an in-memory buffer.
@@ -49,15 +116,17 @@ class buffer_reader {
     friend struct shallow_copy;
 
   public:
+    using checkpoint_type = std::size_t; //!< a checkpoint of a buffer_reader is its cursor
+
     /**
      * @brief wrapper aground the buffer line: used to respect the meta::line_reader concept
      */
     class buffer_line {
       public:
-        explicit buffer_line(std::string_view l)
+        explicit constexpr buffer_line(std::string_view l)
             : line_(l) {}
 
-        [[nodiscard]] std::string_view get() const { return line_; }
+        [[nodiscard]] constexpr std::string_view get() const { return line_; }
 
       private:
         std::string_view line_;
@@ -74,12 +143,16 @@ class buffer_reader {
     buffer_reader(buffer_reader&& other) noexcept
         : buffer_(std::move(other.buffer_))
         , buffer_access_(buffer_.empty() ? other.buffer_access_ : buffer_)
-        , cursor_(other.cursor_) {}
+        , cursor_(other.cursor_)
+        , line_index_(std::move(other.line_index_))
+        , stats_(std::move(other.stats_)) {}
 
     buffer_reader& operator=(buffer_reader&& other) noexcept {
         buffer_        = std::move(other.buffer_);
         buffer_access_ = buffer_.empty() ? other.buffer_access_ : std::string_view(buffer_.begin(), buffer_.end());
         cursor_        = other.cursor_;
+        line_index_    = std::move(other.line_index_);
+        stats_         = std::move(other.stats_);
         return *this;
     }
     buffer_reader(const buffer_reader&)            = default;
@@ -90,6 +163,28 @@ class buffer_reader {
      */
     [[nodiscard]] std::size_t reader_cursor() const { return cursor_; }
 
+    /**
+     * @return checkpoint of the current state of the reader, @see restore
+     */
+    [[nodiscard]] constexpr checkpoint_type checkpoint() const { return cursor_; }
+
+    /**
+     * @brief restore the reader at the state it had when the checkpoint was made
+     * @param checkpoint to restore the reader to
+     */
+    constexpr void restore(checkpoint_type checkpoint) {
+        if (checkpoint < cursor_) {
+            stats_.record_backtrack(cursor_ - checkpoint);
+        }
+        cursor_ = checkpoint;
+    }
+
+    /**
+     * @return statistics of the backtracks and shallow copies of the reader and of its shallow copies (all zeros if
+     * FIL_READER_STATS isn't defined)
+     */
+    [[nodiscard]] reader_stats stats() const { return stats_.snapshot(); }
+
     /**
      * @note the buffer cursor progress forward
      * @return the next character of the buffer, if any
@@ -123,39 +218,42 @@ class buffer_reader {
         return buffer_access_[cursor_];
     }
 
+    /**
+     * @brief enable the sparse line index used by @c read_line, built on its first call and shared with the shallow copies
+     * @param stride number of lines in between two offsets stored in the index
+     */
+    void enable_line_index(std::size_t stride = line_index::DEFAULT_STRIDE) { line_index_ = std::make_shared<line_index>(stride); }
+
     buffer_line read_line(std::size_t line_nb) {
-        std::size_t cursor_begin        = 0;
-        std::size_t cursor_end          = 0;
-        std::size_t current_line_number = 1;
-
-        for (const char c : buffer_access_) {
-            if (current_line_number < line_nb)
-                ++cursor_begin;
-            if (c == '\n')
-                ++current_line_number;
-            if (current_line_number > line_nb)
-                break;
-            ++cursor_end;
+        if (line_index_ == nullptr) {
+            return buffer_line {details_::read_buffer_line(buffer_access_, cursor_, line_nb)};
         }
-        cursor_ = cursor_end + (cursor_end < buffer_access_.size() ? 1 : 0);
-
-        return buffer_line {buffer_access_.substr(cursor_begin, cursor_end - cursor_begin)};
+        if (!line_index_->is_built()) {
+            *line_index_ = line_index::build(buffer_access_, line_index_->stride());
+        }
+        const auto location = line_index_->locate(line_nb);
+        if (!location.has_value()) {
+            cursor_ = buffer_access_.size();
+            return buffer_line {{}};
+        }
+        cursor_ = location->offset;
+        details_::skip_buffer_lines(buffer_access_, cursor_, location->lines_to_skip);
+        return next_line();
     }
 
-    buffer_line next_line() {
-        const std::size_t cursor_begin = cursor_;
-        std::size_t cursor_end         = cursor_;
-
-        const auto it = std::ranges::find_if(buffer_access_.substr(cursor_), [&cursor_end](const char c) {
-            ++cursor_end;
-            return c == '\n';
-        });
+    buffer_line next_line() { return buffer_line {details_::next_buffer_line(buffer_access_, cursor_)}; }
 
-        cursor_ = cursor_end;
+    /**
+     * @brief retrieve the next lines of the buffer in a batch
+     * @param lines filled with the next lines (without the end of line character), up to its size
+     * @return number of lines filled, 0 if the end of the buffer is reached
+     */
+    std::size_t next_lines(std::span<std::string_view> lines) { return details_::next_buffer_lines(buffer_access_, cursor_, lines); }
 
-        const bool line_found = it != buffer_access_.end();
-        return buffer_line {buffer_access_.substr(cursor_begin, cursor_end - cursor_begin - (line_found ? 1 : 0))};
-    }
+    /**
+     * @return number of lines of the buffer (a last line without end of line character is counted)
+     */
+    [[nodiscard]] std::size_t count_lines() const { return fil::count_lines(buffer_access_); }
 
     /**
      * @return true if the buffer is the result of shallow_copy
@@ -169,10 +267,13 @@ class buffer_reader {
     std::string buffer_;
     std::string_view buffer_access_;
     std::size_t cursor_ = 0;
+    std::shared_ptr<line_index> line_index_;                 //!< sparse line index shared with shallow copies, if enabled
+    [[no_unique_address]] details_::stats_recorder<> stats_; //!< statistics, shared with the shallow copies
 };
 
 static_assert(meta::bytes_reader<buffer_reader>, "buffer_reader must be a byte reader");
 static_assert(meta::line_reader<buffer_reader>, "buffer_reader must be a line reader");
+static_assert(meta::checkpoint_reader<buffer_reader>, "buffer_reader must be a checkpoint reader");
 
 /**
  * @brief specialization of the shallow_copy making it possible to copy the buffer without copying the buffer.
@@ -183,12 +284,119 @@ struct shallow_copy<buffer_reader> {
         buffer_reader shallow;
         shallow.buffer_access_ = object.buffer_access_;
         shallow.cursor_        = object.cursor_;
+        shallow.line_index_    = object.line_index_;
+        object.stats_.record_shallow_copy();
+        shallow.stats_ = object.stats_;
         return shallow;
     }
 
     static constexpr auto assign(buffer_reader& object, buffer_reader&& other) { object.cursor_ = other.cursor_; }
 };
 
+/**
+ * @class buffer_view_reader
+ * @brief Non-owning reader over an existing contiguous memory (network buffer, memory mapping, string literal...).
+ *
+ * The `buffer_view_reader` never copies nor allocates: it is a view and a cursor, trivially copyable (its shallow copy
+ * is a plain copy) and constexpr constructible. The memory read has to outlive the reader and the lines retrieved.
+ */
+class buffer_view_reader {
+  public:
+    using checkpoint_type = std::size_t;                //!< a checkpoint of a buffer_view_reader is its cursor
+    using buffer_line     = buffer_reader::buffer_line; //!< line retrieved, view on the memory read
+
+    constexpr buffer_view_reader() = default;
+
+    explicit constexpr buffer_view_reader(std::string_view buffer)
+        : buffer_access_(buffer) {}
+
+    constexpr buffer_view_reader(const char* data, std::size_t size)
+        : buffer_access_(data, size) {}
+
+    /**
+     * @return buffer cursor
+     */
+    [[nodiscard]] constexpr std::size_t reader_cursor() const { return cursor_; }
+
+    /**
+     * @return memory read by the reader
+     */
+    [[nodiscard]] constexpr std::string_view view() const { return buffer_access_; }
+
+    /**
+     * @return checkpoint of the current state of the reader, @see restore
+     */
+    [[nodiscard]] constexpr checkpoint_type checkpoint() const { return cursor_; }
+
+    /**
+     * @brief restore the reader at the state it had when the checkpoint was made
+     * @param checkpoint to restore the reader to
+     */
+    constexpr void restore(checkpoint_type checkpoint) { cursor_ = checkpoint; }
+
+    /**
+     * @note the buffer cursor progress forward
+     * @return the next character of the buffer, if any
+     */
+    [[nodiscard]] constexpr std::optional<std::uint8_t> next_byte() {
+        if (cursor_ >= buffer_access_.size()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(buffer_access_[cursor_++]);
+    }
+
+    /**
+     * @note the buffer cursor progress backward
+     * @return the previous character of the buffer, if any
+     */
+    constexpr std::optional<std::uint8_t> previous_byte() {
+        if (cursor_ == 0) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(buffer_access_[--cursor_]);
+    }
+
+    /**
+     * @note the buffer cursor doesn't progress forward
+     * @return the next character, if any
+     */
+    [[nodiscard]] constexpr std::optional<std::uint8_t> peek() const {
+        if (cursor_ >= buffer_access_.size()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(buffer_access_[cursor_]);
+    }
+
+    /**
+     * @param line_nb number of the line to read (starting from 1)
+     * @return the line, empty if the buffer has less lines (the cursor is then at the end of the buffer)
+     */
+    buffer_line read_line(std::size_t line_nb) { return buffer_line {details_::read_buffer_line(buffer_access_, cursor_, line_nb)}; }
+
+    buffer_line next_line() { return buffer_line {details_::next_buffer_line(buffer_access_, cursor_)}; }
+
+    /**
+     * @brief retrieve the next lines of the buffer in a batch
+     * @param lines filled with the next lines (without the end of line character), up to its size
+     * @return number of lines filled, 0 if the end of the buffer is reached
+     */
+    std::size_t next_lines(std::span<std::string_view> lines) { return details_::next_buffer_lines(buffer_access_, cursor_, lines); }
+
+    /**
+     * @return number of lines of the buffer (a last line without end of line character is counted)
+     */
+    [[nodiscard]] std::size_t count_lines() const { return fil::count_lines(buffer_access_); }
+
+  private:
+    std::string_view buffer_access_ {}; //!< memory read, not owned
+    std::size_t cursor_ {0};            //!< position of the next character to read
+};
+
+static_assert(meta::bytes_reader<buffer_view_reader>, "buffer_view_reader must be a byte reader");
+static_assert(meta::line_reader<buffer_view_reader>, "buffer_view_reader must be a line reader");
+static_assert(meta::checkpoint_reader<buffer_view_reader>, "buffer_view_reader must be a checkpoint reader");
+static_assert(std::is_trivially_copyable_v<buffer_view_reader>, "buffer_view_reader must be trivially copyable");
+
 } // namespace fil
 
 #endif // FIL_BUFFER_READER_HH
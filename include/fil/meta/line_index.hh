@@ -0,0 +1,209 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_LINE_INDEX_HH
+#define FIL_LINE_INDEX_HH
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "fil/algorithm/line_scan.hh"
+
+namespace fil {
+
+/**
+ * @brief Sparse index of the beginning of the lines of a content.
+ *
+ * @details The offset of the beginning of a line is stored every `stride` lines: retrieving a line is a jump to the
+ * closest indexed line followed by the scan of at most `stride - 1` lines (instead of a scan from the beginning of the
+ * content). The memory cost is 8 bytes every `stride` lines.
+ *
+ * The index can be saved into (and loaded from) a sidecar file, keyed by the size and the modification time of the
+ * file indexed: an index of an outdated version of a file is never loaded.
+ */
+class line_index {
+    static constexpr std::array<char, 4> MAGIC {'F', 'L', 'I', 'X'};
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+  public:
+    static constexpr std::size_t DEFAULT_STRIDE = 1024; //!< default number of lines in between two offsets stored
+
+    /**
+     * @brief position of a line given by the index
+     */
+    struct location {
+        std::size_t offset;        //!< offset of the closest indexed line preceding (or being) the line looked for
+        std::size_t lines_to_skip; //!< number of lines to skip from the offset to reach the line looked for
+    };
+
+    explicit line_index(std::size_t stride = DEFAULT_STRIDE)
+        : stride_(std::max<std::size_t>(stride, 1)) {}
+
+    /**
+     * @brief build the index of a content
+     * @param content to index
+     * @param stride number of lines in between two offsets stored
+     * @return index of the content
+     */
+    [[nodiscard]] static line_index build(std::string_view content, std::size_t stride = DEFAULT_STRIDE) {
+        line_index index(stride);
+
+        std::size_t newlines = 0;
+        const char* begin    = content.data();
+        const char* end      = begin + content.size();
+        for (const char* it = begin; it < end;) {
+            const char* found = find_newline(it, end);
+            if (found == end) {
+                break;
+            }
+            it = found + 1;
+            if (++newlines % index.stride_ == 0) {
+                index.offsets_.push_back(static_cast<std::uint64_t>(it - begin));
+            }
+        }
+        index.line_count_ = newlines + (!content.empty() && content.back() != '\n' ? 1 : 0);
+        index.built_      = true;
+        return index;
+    }
+
+    /**
+     * @param line number of the line to locate (starting at 1)
+     * @return location of the line, nullopt if the line doesn't exist
+     */
+    [[nodiscard]] std::optional<location> locate(std::size_t line) const {
+        if (line == 0 || line > line_count_) {
+            return std::nullopt;
+        }
+        return location {
+            .offset        = static_cast<std::size_t>(offsets_[(line - 1) / stride_]),
+            .lines_to_skip = (line - 1) % stride_,
+        };
+    }
+
+    [[nodiscard]] bool is_built() const { return built_; }
+    [[nodiscard]] std::size_t line_count() const { return line_count_; }
+    [[nodiscard]] std::size_t stride() const { return stride_; }
+
+    /**
+     * @brief save the index into a sidecar file
+     * @param path of the sidecar file
+     * @param file_size size of the file indexed
+     * @param modification_time last modification time of the file indexed (as a count since epoch)
+     * @return true if the index has been saved, false otherwise
+     */
+    bool save(const std::filesystem::path& path, std::uint64_t file_size, std::int64_t modification_time) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        const std::uint64_t stride     = stride_;
+        const std::uint64_t line_count = line_count_;
+        const std::uint64_t offsets    = offsets_.size();
+
+        out.write(MAGIC.data(), MAGIC.size());
+        write_(out, FORMAT_VERSION);
+        write_(out, file_size);
+        write_(out, modification_time);
+        write_(out, stride);
+        write_(out, line_count);
+        write_(out, offsets);
+        out.write(reinterpret_cast<const char*>(offsets_.data()), static_cast<std::streamsize>(offsets * sizeof(std::uint64_t)));
+        return out.good();
+    }
+
+    /**
+     * @brief load an index from a sidecar file
+     * @param path of the sidecar file
+     * @param file_size current size of the file indexed
+     * @param modification_time current last modification time of the file indexed (as a count since epoch)
+     * @return index loaded, nullopt if the sidecar doesn't exist, is invalid or has been made for another version of the file
+     */
+    [[nodiscard]] static std::optional<line_index> load(const std::filesystem::path& path, std::uint64_t file_size,
+                                                        std::int64_t modification_time) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return std::nullopt;
+        }
+
+        std::array<char, 4> magic {};
+        std::uint32_t version {};
+        std::uint64_t size {};
+        std::int64_t time {};
+        std::uint64_t stride {};
+        std::uint64_t line_count {};
+        std::uint64_t offsets {};
+
+        in.read(magic.data(), magic.size());
+        if (!in || magic != MAGIC || !read_(in, version) || version != FORMAT_VERSION //
+            || !read_(in, size) || size != file_size || !read_(in, time) || time != modification_time
+            || !read_(in, stride) || stride == 0 || !read_(in, line_count) || !read_(in, offsets) || offsets == 0
+            || (line_count > 0 && (line_count - 1) / stride >= offsets)) {
+            return std::nullopt;
+        }
+        // a corrupted sidecar can have a valid header: the number of offsets is bound by the size of the file indexed (a
+        // line is at least one byte long) and has to match the size of the sidecar, before allocating anything
+        std::error_code ec;
+        const auto sidecar_size = std::filesystem::file_size(path, ec);
+        const auto header_size  = static_cast<std::uint64_t>(in.tellg());
+        if (ec || line_count > file_size || offsets > file_size / stride + 1 || sidecar_size < header_size
+            || (sidecar_size - header_size) / sizeof(std::uint64_t) != offsets
+            || (sidecar_size - header_size) % sizeof(std::uint64_t) != 0) {
+            return std::nullopt;
+        }
+
+        line_index index(stride);
+        index.offsets_.resize(offsets);
+        in.read(reinterpret_cast<char*>(index.offsets_.data()), static_cast<std::streamsize>(offsets * sizeof(std::uint64_t)));
+        if (!in) {
+            return std::nullopt;
+        }
+        index.line_count_ = line_count;
+        index.built_      = true;
+        return index;
+    }
+
+  private:
+    template<typename T>
+    static void write_(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static bool read_(std::istream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+  private:
+    std::size_t stride_;                     //!< number of lines in between two offsets stored
+    std::vector<std::uint64_t> offsets_ {0}; //!< offsets_[i] is the offset of the line (i * stride_ + 1)
+    std::size_t line_count_ {0};             //!< number of lines of the content indexed
+    bool built_ {false};                     //!< true once the index has been built (or loaded)
+};
+
+} // namespace fil
+
+#endif // FIL_LINE_INDEX_HH
@@ -24,6 +24,13 @@
 #ifndef FIL_READER_HH
 #define FIL_READER_HH
 
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
 namespace fil::meta {
 
 template<typename T>
@@ -48,6 +55,17 @@ concept bytes_reader =              //
         { reader_.reader_cursor() } -> std::convertible_to<std::size_t>;
     };
 
+/**
+ * @brief reader able to save its current state into a lightweight checkpoint, and to be restored to it later on.
+ * A checkpoint is meant to be cheap to take (a cursor and a load identifier), and is used to backtrack without copying
+ * the reader.
+ */
+template<typename T>
+concept checkpoint_reader = requires(T& reader_, const typename T::checkpoint_type& checkpoint) {
+    { reader_.checkpoint() } -> std::convertible_to<typename T::checkpoint_type>;
+    { reader_.restore(checkpoint) };
+};
+
 } // namespace fil::meta
 
 #endif // FIL_READER_HH
@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2025 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/FiL
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FIL_READER_STATS_HH
+#define FIL_READER_STATS_HH
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace fil {
+
+// I/O statistics of the readers.
+//
+// The collection is enabled at compile time by defining FIL_READER_STATS (cmake option WITH_FIL_READER_STATS). When it
+// isn't defined, the recorder of a reader is an empty object whose calls compile to nothing, and the statistics of the
+// readers are all zeros. The whole program has to be compiled with the same setting (the layout of the readers differs).
+
+#if defined(FIL_READER_STATS)
+static constexpr bool READER_STATS_ENABLED = true; //!< true if the readers collect their I/O statistics
+#else
+static constexpr bool READER_STATS_ENABLED = false; //!< true if the readers collect their I/O statistics
+#endif
+
+/**
+ * @brief I/O statistics of a reader, aggregated over its shallow copies
+ */
+struct reader_stats {
+    std::uint64_t bytes_read {0};         //!< bytes read from the file
+    std::uint64_t bytes_reread {0};       //!< bytes read again (already read by the previous read, or after a backtrack)
+    std::uint64_t loads {0};              //!< number of loads of the buffer
+    std::uint64_t backward_seeks {0};     //!< number of reads starting before the end of the previous read, and of backtracks
+    std::uint64_t shallow_copies {0};     //!< number of shallow copies made of the reader (and of its copies)
+    std::chrono::nanoseconds io_wait {0}; //!< time spent blocked waiting for the reads
+};
+
+namespace details_ {
+
+/**
+ * @brief recorder of the statistics of a reader, no-op when the statistics are disabled
+ */
+template<bool Enabled = READER_STATS_ENABLED>
+class stats_recorder {
+  public:
+    constexpr void record_load() {}
+    constexpr void record_read(std::size_t, std::size_t) {}
+    constexpr void record_backtrack(std::size_t) {}
+    constexpr void record_shallow_copy() const {}
+
+    template<typename Fn>
+    constexpr auto timed(Fn&& fn) {
+        return std::forward<Fn>(fn)();
+    }
+
+    [[nodiscard]] constexpr reader_stats snapshot() const { return {}; }
+};
+
+template<>
+class stats_recorder<true> {
+    struct counters {
+        std::atomic<std::uint64_t> bytes_read {0};
+        std::atomic<std::uint64_t> bytes_reread {0};
+        std::atomic<std::uint64_t> loads {0};
+        std::atomic<std::uint64_t> backward_seeks {0};
+        std::atomic<std::uint64_t> shallow_copies {0};
+        std::atomic<std::int64_t> io_wait {0}; //!< in nanoseconds
+    };
+
+  public:
+    void record_load() { shared_().loads.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @param position in the file of the beginning of the read
+     * @param size number of bytes read
+     */
+    void record_read(std::size_t position, std::size_t size) {
+        shared_().bytes_read.fetch_add(size, std::memory_order_relaxed);
+        if (position < last_read_end_) {
+            record_backtrack(std::min(last_read_end_, position + size) - position);
+        }
+        last_read_end_ = position + size;
+    }
+
+    /**
+     * @brief record a move of the reader backward (restore to an earlier checkpoint...)
+     * @param distance number of bytes to read again
+     */
+    void record_backtrack(std::size_t distance) {
+        auto& counters = shared_();
+        counters.backward_seeks.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes_reread.fetch_add(distance, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief record a shallow copy of the reader: the copy (copying the recorder) shares the counters
+     */
+    void record_shallow_copy() const { shared_().shallow_copies.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief call a function doing a blocking read, the time spent in it being recorded
+     */
+    template<typename Fn>
+    auto timed(Fn&& fn) {
+        const auto start  = std::chrono::steady_clock::now();
+        auto result       = std::forward<Fn>(fn)();
+        const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        shared_().io_wait.fetch_add(waited.count(), std::memory_order_relaxed);
+        return result;
+    }
+
+    [[nodiscard]] reader_stats snapshot() const {
+        if (counters_ == nullptr) {
+            return {};
+        }
+        return {
+            .bytes_read     = counters_->bytes_read.load(std::memory_order_relaxed),
+            .bytes_reread   = counters_->bytes_reread.load(std::memory_order_relaxed),
+            .loads          = counters_->loads.load(std::memory_order_relaxed),
+            .backward_seeks = counters_->backward_seeks.load(std::memory_order_relaxed),
+            .shallow_copies = counters_->shallow_copies.load(std::memory_order_relaxed),
+            .io_wait        = std::chrono::nanoseconds(counters_->io_wait.load(std::memory_order_relaxed)),
+        };
+    }
+
+  private:
+    /**
+     * @return counters shared with the shallow copies, allocated on the first record
+     */
+    counters& shared_() const {
+        if (counters_ == nullptr) {
+            counters_ = std::make_shared<counters>();
+        }
+        return *counters_;
+    }
+
+  private:
+    mutable std::shared_ptr<counters> counters_; //!< counters shared with the copies of the reader
+    std::size_t last_read_end_ {0};              //!< position in the file of the end of the previous read
+};
+
+} // namespace details_
+
+} // namespace fil
+
+#endif // FIL_READER_STATS_HH
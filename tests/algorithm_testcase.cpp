@@ -21,10 +21,15 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
+#include <tuple>
 #include <variant>
 
 #include <catch2/catch_test_macros.hpp>
 #include <fil/algorithm/contains.hh>
+#include <fil/algorithm/delimited_scan.hh>
+#include <fil/algorithm/hash.hh>
+#include <fil/algorithm/line_scan.hh>
 #include <fil/algorithm/string.hh>
 #include <fil/algorithm/suitable.hh>
 #include <fil/meta/tuple.hh>
@@ -425,4 +430,117 @@ TEST_CASE("fil algorithm to_string", "[algorithm]") {
         const std::variant<int, std::string, double> variant_dblvalue {1337.42};
         CHECK(fil::to_string(variant_dblvalue) == "1337.42");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("algorithm_testcase hash_content", "[algorithm]") {
+
+    SECTION("reference values") {
+        CHECK(fil::hash_content("") == 0xEF46DB3751D8E999ULL);
+        CHECK(fil::hash_content("abc") == 0x44BC2CF5AD770999ULL);
+    }
+
+    SECTION("content bigger than a stripe") {
+        const std::string content(1000, 'a');
+        std::string modified = content;
+        modified[999]        = 'b';
+
+        CHECK(fil::hash_content(content) == fil::hash_content(content));
+        CHECK(fil::hash_content(content) != fil::hash_content(modified));
+    }
+
+    SECTION("seeded") {
+        CHECK(fil::hash_content("chocobo", 1) != fil::hash_content("chocobo", 2));
+    }
+}
+
+TEST_CASE("algorithm_testcase line_scan", "[algorithm]") {
+
+    SECTION("count_lines") {
+        CHECK(fil::count_lines("") == 0);
+        CHECK(fil::count_lines("chocobo") == 1);
+        CHECK(fil::count_lines("chocobo\n") == 1);
+        CHECK(fil::count_lines("choco\n\nbo") == 3);
+
+        std::string content;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            content += (i % 7 == 0) ? '\n' : 'x'; // covers the vectorized part and the scalar tail
+        }
+        CHECK(fil::count_newlines(content.data(), content.data() + content.size()) == 143);
+    }
+
+    SECTION("split_lines") {
+        std::array<std::string_view, 2> lines {};
+
+        auto [filled, consumed] = fil::split_lines("kweh\n\nchocobo", lines);
+        CHECK(filled == 2);
+        CHECK(consumed == 6);
+        CHECK(lines[0] == "kweh");
+        CHECK(lines[1].empty());
+
+        std::tie(filled, consumed) = fil::split_lines("chocobo", lines, false);
+        CHECK(filled == 0);
+        CHECK(consumed == 0);
+
+        std::tie(filled, consumed) = fil::split_lines("chocobo", lines);
+        CHECK(filled == 1);
+        CHECK(lines[0] == "chocobo");
+    }
+
+    SECTION("find_last_newline") {
+        const std::string_view none = "chocobo";
+        CHECK(fil::find_last_newline(none.data(), none.data() + none.size()) == none.data() + none.size());
+
+        std::string content(1000, 'x');
+        content[3]   = '\n';
+        content[500] = '\n';
+        const char* begin = content.data();
+        CHECK(fil::find_last_newline(begin, begin + content.size()) == begin + 500); // vectorized part
+        CHECK(fil::find_last_newline(begin, begin + 500) == begin + 3);              // scalar head
+        CHECK(fil::find_last_newline(begin, begin + 3) == begin + 3);
+        CHECK(fil::find_last_newline(begin + 4, begin + 500) == begin + 500);
+    }
+}
+
+TEST_CASE("algorithm_testcase delimited_scan", "[algorithm]") {
+    std::vector<std::string_view> fields;
+
+    SECTION("simple records") {
+        fil::delimited_scanner scanner("a,b,c\n1,,3\nlast,record");
+        REQUIRE(scanner.next(fields));
+        CHECK(fields == std::vector<std::string_view> {"a", "b", "c"});
+        REQUIRE(scanner.next(fields));
+        CHECK(fields == std::vector<std::string_view> {"1", "", "3"});
+        REQUIRE(scanner.next(fields));
+        CHECK(fields == std::vector<std::string_view> {"last", "record"});
+        CHECK(!scanner.next(fields));
+        CHECK(fields.empty());
+    }
+
+    SECTION("quoted fields, CRLF and empty lines") {
+        fil::delimited_scanner scanner("\"a,b\",\"multi\nline\",\"say \"\"hi\"\"\"\r\n\r\n\nx,\"\"\r\n");
+        REQUIRE(scanner.next(fields));
+        CHECK(fields == std::vector<std::string_view> {"a,b", "multi\nline", "say \"\"hi\"\""});
+        CHECK(fil::unescape_field(fields[2]) == "say \"hi\"");
+        REQUIRE(scanner.next(fields));
+        CHECK(fields == std::vector<std::string_view> {"x", ""});
+        CHECK(!scanner.next(fields));
+    }
+
+    SECTION("dialect and records over several blocks") {
+        std::string content;
+        for (std::size_t i = 0; i < 500; ++i) {
+            content += std::to_string(i) + "\t'quoted\tfield " + std::to_string(i) + "'\t" + std::string(i % 70, 'x') + "\n";
+        }
+        fil::delimited_scanner scanner(content, {.delimiter = '\t', .quote = '\''});
+        std::size_t records = 0;
+        while (scanner.next(fields)) {
+            REQUIRE(fields.size() == 3);
+            CHECK(fields[0] == std::to_string(records));
+            CHECK(fields[1] == "quoted\tfield " + std::to_string(records));
+            CHECK(fields[2].size() == records % 70);
+            ++records;
+        }
+        CHECK(records == 500);
+        CHECK(scanner.position() == content.size());
+    }
+}
@@ -0,0 +1,260 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zlib.h>
+#if defined(FIL_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+#include "fil/copa/copa.hh"
+#include "fil/copa/matcher.hh"
+#include "fil/copa/sink.hh"
+#include "fil/file/compressed_file_reader.hh"
+
+namespace {
+
+void write_file(const std::filesystem::path& file_path, const std::string& content) {
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(fmt::format("Could not open file for writing: {}", file_path.c_str()));
+    }
+    file << content;
+}
+
+//! write the content as a gzip file, made of one member per part
+void write_gzip(const std::filesystem::path& file_path, const std::vector<std::string>& parts) {
+    std::string compressed;
+    for (const auto& part : parts) {
+        z_stream stream {};
+        REQUIRE(::deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+        std::string member(::deflateBound(&stream, part.size()), '\0');
+        stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(part.data()));
+        stream.avail_in  = static_cast<uInt>(part.size());
+        stream.next_out  = reinterpret_cast<Bytef*>(member.data());
+        stream.avail_out = static_cast<uInt>(member.size());
+        REQUIRE(::deflate(&stream, Z_FINISH) == Z_STREAM_END);
+        member.resize(stream.total_out);
+        ::deflateEnd(&stream);
+        compressed += member;
+    }
+    write_file(file_path, compressed);
+}
+
+#if defined(FIL_WITH_ZSTD)
+//! write the content as a zstd file, made of one frame per part
+void write_zstd(const std::filesystem::path& file_path, const std::vector<std::string>& parts) {
+    std::string compressed;
+    for (const auto& part : parts) {
+        std::string frame(::ZSTD_compressBound(part.size()), '\0');
+        const auto size = ::ZSTD_compress(frame.data(), frame.size(), part.data(), part.size(), 1);
+        REQUIRE(!::ZSTD_isError(size));
+        frame.resize(size);
+        compressed += frame;
+    }
+    write_file(file_path, compressed);
+}
+#endif
+
+std::string make_lines(std::size_t count, std::size_t first = 0) {
+    std::string content;
+    for (std::size_t i = first; i < first + count; ++i) {
+        content += fmt::format("line number {} of the compressed file\n", i);
+    }
+    return content;
+}
+
+} // namespace
+
+TEST_CASE("compressed_file_reader", "[reader][compression]") {
+    const auto tmp = std::filesystem::temp_directory_path() / "fil_compressed_reader_test";
+    std::filesystem::remove_all(tmp);
+    std::filesystem::create_directories(tmp);
+
+    SECTION("detect compression") {
+        CHECK(fil::detect_compression("\x1f\x8b\x08") == fil::compression::gzip);
+        CHECK(fil::detect_compression("\x28\xb5\x2f\xfd") == fil::compression::zstd);
+        CHECK(fil::detect_compression("plain text") == fil::compression::none);
+        CHECK(fil::detect_compression("") == fil::compression::none);
+    }
+
+    SECTION("uncompressed file is read as is") {
+        write_file(tmp / "plain.txt", "first\nsecond\nthird");
+        fil::compressed_file_reader reader(tmp / "plain.txt");
+
+        REQUIRE(reader.is_open());
+        CHECK(reader.compression_type() == fil::compression::none);
+        CHECK(reader.next_line().get() == "first");
+        CHECK(reader.next_line().get() == "second");
+        CHECK(reader.next_line().get() == "third");
+        CHECK(!reader.next_line().is_valid());
+    }
+
+    SECTION("gzip :: bytes") {
+        write_gzip(tmp / "bytes.gz", {"abc"});
+        fil::compressed_file_reader reader(tmp / "bytes.gz");
+
+        REQUIRE(reader.is_open());
+        CHECK(reader.compression_type() == fil::compression::gzip);
+        CHECK(reader.peek() == 'a');
+        CHECK(reader.next_byte() == 'a');
+        CHECK(reader.next_byte() == 'b');
+        CHECK(reader.previous_byte() == 'b');
+        CHECK(reader.next_byte() == 'b');
+        CHECK(reader.next_byte() == 'c');
+        CHECK(reader.next_byte() == std::nullopt);
+        CHECK(reader.peek() == std::nullopt);
+        CHECK(!reader.has_error());
+    }
+
+    SECTION("gzip :: lines over several blocks and members") {
+        const auto first  = make_lines(40'000);
+        const auto second = make_lines(40'000, 40'000);
+        REQUIRE(first.size() + second.size() > 2 * fil::DECOMPRESSION_BLOCK_SIZE);
+        write_gzip(tmp / "lines.gz", {first, second});
+
+        fil::compressed_file_reader reader(tmp / "lines.gz");
+        std::size_t count = 0;
+        for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+            REQUIRE(line.get() == fmt::format("line number {} of the compressed file", count));
+            ++count;
+        }
+        CHECK(count == 80'000);
+        CHECK(!reader.has_error());
+        CHECK(reader.reader_cursor() == first.size() + second.size());
+
+        SECTION("read_line") {
+            CHECK(reader.read_line(1).get() == "line number 0 of the compressed file");
+            CHECK(reader.read_line(60'001).get() == "line number 60000 of the compressed file");
+            CHECK(reader.next_line().get() == "line number 60001 of the compressed file");
+            CHECK(!reader.read_line(80'001).is_valid());
+        }
+
+        SECTION("line iterator") {
+            std::size_t iterated = 0;
+            for (auto it = reader.make_line_iterator(79'998); it != reader.end(); ++it) {
+                CHECK(it->get() == fmt::format("line number {} of the compressed file", 79'997 + iterated));
+                ++iterated;
+            }
+            CHECK(iterated == 3);
+        }
+    }
+
+    SECTION("gzip :: checkpoint and restore") {
+        write_gzip(tmp / "checkpoint.gz", {make_lines(50'000)});
+        fil::compressed_file_reader reader(tmp / "checkpoint.gz");
+
+        std::ignore           = reader.next_line();
+        const auto checkpoint = reader.checkpoint();
+        CHECK(reader.next_line().get() == "line number 1 of the compressed file");
+
+        for (int i = 0; i < 45'000; ++i) {
+            std::ignore = reader.next_line();
+        }
+        const auto far_checkpoint = reader.checkpoint();
+        CHECK(reader.next_line().get() == "line number 45002 of the compressed file");
+
+        reader.restore(checkpoint);
+        CHECK(reader.next_line().get() == "line number 1 of the compressed file");
+
+        reader.restore(far_checkpoint);
+        CHECK(reader.next_line().get() == "line number 45002 of the compressed file");
+    }
+
+    SECTION("gzip :: line longer than a block") {
+        const std::string long_line(fil::DECOMPRESSION_BLOCK_SIZE * 2 + 17, 'x');
+        write_gzip(tmp / "long.gz", {"short\n" + long_line + "\nend\n"});
+        fil::compressed_file_reader reader(tmp / "long.gz");
+
+        CHECK(reader.next_line().get() == "short");
+        CHECK(reader.next_line().get() == long_line);
+        CHECK(reader.next_line().get() == "end");
+        CHECK(!reader.next_line().is_valid());
+    }
+
+    SECTION("gzip :: truncated file") {
+        write_gzip(tmp / "full.gz", {make_lines(1'000)});
+        std::ifstream full(tmp / "full.gz", std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(full)), std::istreambuf_iterator<char>());
+        write_file(tmp / "truncated.gz", content.substr(0, content.size() / 2));
+
+        fil::compressed_file_reader reader(tmp / "truncated.gz");
+        while (reader.next_line().is_valid()) {}
+        CHECK(reader.has_error());
+    }
+
+    SECTION("gzip :: copa parse") {
+        write_gzip(tmp / "parse.gz", {"chocobo "});
+
+        struct grammar {
+            struct ast_object {
+                std::string value;
+            };
+
+            static constexpr fil::copa::rule auto rules() { return fil::copa::match_identifier<fil::copa::member<&ast_object::value>> {}; }
+            static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+        };
+
+        auto g       = grammar {};
+        const auto v = fil::copa::parse(g, fil::compressed_file_reader(tmp / "parse.gz"));
+        REQUIRE(v.has_value());
+        CHECK(v->value == "chocobo");
+    }
+
+#if defined(FIL_WITH_ZSTD)
+    SECTION("zstd :: frames decompressed sequentially and in parallel") {
+        std::vector<std::string> frames;
+        std::string expected;
+        for (std::size_t i = 0; i < 8; ++i) {
+            frames.push_back(make_lines(10'000, i * 10'000));
+            expected += frames.back();
+        }
+        write_zstd(tmp / "lines.zst", frames);
+
+        // small memory limit: the frames are too big to be decompressed in parallel, they are streamed
+        for (const auto options : {fil::decompression_options {.threads = 1}, fil::decompression_options {.threads = 4},
+                                   fil::decompression_options {.threads = 4, .memory_limit = 1024}}) {
+            fil::compressed_file_reader reader(tmp / "lines.zst", options);
+            REQUIRE(reader.compression_type() == fil::compression::zstd);
+
+            std::string content;
+            for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+                content += line.get();
+                content += '\n';
+            }
+            CHECK(content == expected);
+            CHECK(!reader.has_error());
+            CHECK(reader.read_line(70'001).get() == "line number 70000 of the compressed file");
+        }
+    }
+
+    SECTION("zstd :: single frame and big frames are streamed") {
+        const auto big   = make_lines(100'000);
+        const auto small = make_lines(100, 100'000);
+        write_zstd(tmp / "single.zst", {big});
+        write_zstd(tmp / "mixed.zst", {small, big, small, small});
+
+        const std::vector<std::pair<std::filesystem::path, std::string>> files {
+            {tmp / "single.zst", big},
+            {tmp / "mixed.zst", small + big + small + small},
+        };
+        for (const auto& [file, expected] : files) {
+            // frames up to memory_limit / threads (half of the big frame) are decompressed in parallel
+            fil::compressed_file_reader reader(file, {.threads = 4, .memory_limit = 2 * big.size()});
+            std::string content;
+            for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+                content += line.get();
+                content += '\n';
+            }
+            CHECK(content == expected);
+            CHECK(!reader.has_error());
+        }
+    }
+#endif
+
+    std::filesystem::remove_all(tmp);
+}
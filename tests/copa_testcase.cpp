@@ -1,8 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "fil/copa/cache.hh"
 #include "fil/copa/copa.hh"
 #include "fil/copa/matcher.hh"
 #include "fil/copa/sink.hh"
@@ -12,6 +17,21 @@
 #include "print_error.hh"
 #include "wrapper_utils.hh"
 
+namespace {
+std::atomic<std::size_t> allocation_count {0};
+}
+
+// allocation counting : every operator new of the test executable goes through those replacements
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
 namespace {
 
 template<typename T>
@@ -44,6 +64,22 @@ struct alt_grammar {
     static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
 };
 
+} // namespace
+
+// codec of the cached ast object: aggregates are encoded out of the box only with structured binding packs
+template<>
+struct fil::copa::snapshot::codec<alt_grammar::ast_object> {
+    static void encode(output& out, const alt_grammar::ast_object& value) {
+        codec<std::string>::encode(out, value.type);
+        codec<std::string>::encode(out, value.value);
+    }
+    static bool decode(input& in, alt_grammar::ast_object& value) {
+        return codec<std::string>::decode(in, value.type) && codec<std::string>::decode(in, value.value);
+    }
+};
+
+namespace {
+
 // --- Grammar Definitions ---
 
 struct match_string_grammar {
@@ -103,6 +139,19 @@ TEST_CASE("Copa: standalone test case", "[copa][standalone]") {
         CHECK(result->options[0] == "turbo");
         CHECK(result->options[1] == "fast");
     }
+    SECTION("Successful parse over memory not owned by the reader") {
+        const std::string_view input = "CMD start FOR engine turbo fast ";
+        simple_grammar grammar;
+
+        const auto result = fil::copa::parse(grammar, fil::buffer_view_reader {input});
+
+        REQUIRE(result.has_value());
+        CHECK(result->command == "start");
+        CHECK(result->name == "engine");
+        REQUIRE(result->options.size() == 2);
+        CHECK(result->options[0] == "turbo");
+        CHECK(result->options[1] == "fast");
+    }
     SECTION("Successful parse with different identifiers") {
         // std::string input = "CMD stop FOR system ";
         std::string input = "CMD stop FOR system a ";
@@ -1255,4 +1304,253 @@ TEST_CASE("Copa: AST generator", "[copa][ast]") {
     }
 }
 
+TEST_CASE("Copa: reusable parser", "[copa][reusable]") {
+    fil::copa::reusable_parser<alt_grammar, fil::buffer_reader> parser;
+
+    SECTION("parse without input") {
+        const auto result = parser.parse();
+        REQUIRE_FALSE(result.has_value());
+        CHECK(parser.get_reader() == nullptr);
+    }
+
+    SECTION("successive parses") {
+        const auto res1 = parser.parse(fil::buffer_reader {"INT 42 "});
+        REQUIRE(res1.has_value());
+        CHECK(res1->type == "INT");
+        CHECK(res1->value == "42");
+
+        const auto res2 = parser.parse(fil::buffer_reader {"STR world "});
+        REQUIRE(res2.has_value());
+        CHECK(res2->type == "STR");
+        CHECK(res2->value == "world");
+    }
+
+    SECTION("parse after a failure") {
+        const auto failure = parser.parse(fil::buffer_reader {"INT "});
+        REQUIRE_FALSE(failure.has_value());
+
+        parser.reset(fil::buffer_reader {"INT 1337 "});
+        const auto success = parser.parse();
+        REQUIRE(success.has_value());
+        CHECK(success->type == "INT");
+        CHECK(success->value == "1337");
+        REQUIRE(parser.get_reader() != nullptr);
+    }
+
+    SECTION("warm parser allocations") {
+        const auto count_allocations = [](auto&& parse) {
+            const auto before = allocation_count.load(std::memory_order_relaxed);
+            const bool parsed = parse();
+            const auto after  = allocation_count.load(std::memory_order_relaxed);
+            CHECK(parsed);
+            return after - before;
+        };
+
+        fil::copa::reusable_parser<alt_grammar, fil::buffer_view_reader> warm_parser;
+        const auto warm_parse = [&warm_parser] { return warm_parser.parse(fil::buffer_view_reader {"INT 42 "}).has_value(); };
+        const auto cold_parse = [] {
+            alt_grammar grammar;
+            return fil::copa::parse(grammar, fil::buffer_view_reader {"INT 42 "}).has_value();
+        };
+
+        std::ignore            = count_allocations(warm_parse);
+        const auto first_warm  = count_allocations(warm_parse);
+        const auto second_warm = count_allocations(warm_parse);
+        const auto cold        = count_allocations(cold_parse);
+
+        // the buffers of the parsing context are reused: the allocations left are the ones of the rules, the same at each parse
+        CHECK(first_warm == second_warm);
+        CHECK(first_warm < cold);
+    }
+}
+
+TEST_CASE("Copa: cached parse", "[copa][cache]") {
+    const auto cache_directory = std::filesystem::temp_directory_path() / "fil_copa_cache_testcase";
+    std::filesystem::remove_all(cache_directory);
+
+    alt_grammar grammar;
+
+    SECTION("miss then hit") {
+        const auto input = fil::temporary_file("INT 42 ", "copa_cache");
+
+        const auto miss = fil::copa::cached_parse(grammar, input, cache_directory);
+        REQUIRE(miss.has_value());
+        CHECK(miss->type == "INT");
+        CHECK(miss->value == "42");
+        CHECK(std::ranges::distance(std::filesystem::directory_iterator {cache_directory}) == 1);
+
+        const auto hit = fil::copa::cached_parse(grammar, input, cache_directory);
+        REQUIRE(hit.has_value());
+        CHECK(hit->type == "INT");
+        CHECK(hit->value == "42");
+        CHECK(std::ranges::distance(std::filesystem::directory_iterator {cache_directory}) == 1);
+
+        SECTION("schema version change invalidates the snapshot") {
+            const auto other_version = fil::copa::cached_parse(grammar, input, cache_directory, 1);
+            REQUIRE(other_version.has_value());
+            CHECK(std::ranges::distance(std::filesystem::directory_iterator {cache_directory}) == 2);
+        }
+    }
+
+    SECTION("concurrent stores of the same snapshot") {
+        const auto input = fil::temporary_file("INT 42 ", "copa_cache");
+
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&input, &cache_directory] {
+                alt_grammar thread_grammar;
+                std::error_code ec;
+                for (int parse = 0; parse < 20; ++parse) {
+                    std::filesystem::remove_all(cache_directory, ec); // miss: each thread keeps storing the snapshot
+                    std::ignore = fil::copa::cached_parse(thread_grammar, input, cache_directory);
+                }
+            });
+        }
+        threads.clear();
+
+        const auto result = fil::copa::cached_parse(grammar, input, cache_directory);
+        REQUIRE(result.has_value());
+        CHECK(result->value == "42");
+        // no temporary file left behind, the snapshot stored is complete
+        CHECK(std::ranges::distance(std::filesystem::directory_iterator {cache_directory}) == 1);
+        CHECK(fil::copa::cached_parse(grammar, input, cache_directory)->value == "42");
+    }
+
+    SECTION("failed parse isn't cached") {
+        const auto input = fil::temporary_file("INT ", "copa_cache");
+
+        const auto result = fil::copa::cached_parse(grammar, input, cache_directory);
+        REQUIRE_FALSE(result.has_value());
+        CHECK(!std::filesystem::exists(cache_directory) || std::filesystem::is_empty(cache_directory));
+    }
+
+    SECTION("non-existing input") {
+        const auto result = fil::copa::cached_parse(grammar, cache_directory / "non_existing.txt", cache_directory);
+        REQUIRE_FALSE(result.has_value());
+    }
+
+    SECTION("ast tree snapshot") {
+        using node = fil::copa::ast_node<[](const std::string& token) { return token; }>;
+
+        node tree {.value = "+", .lhs = 1, .rhs = std::make_shared<node>(node {.value = "*", .lhs = 2, .rhs = std::string {"x"}})};
+
+        const auto snapshot = fil::copa::snapshot::serialize(tree);
+        const auto decoded  = fil::copa::snapshot::deserialize<node>(snapshot);
+        REQUIRE(decoded.has_value());
+        CHECK(decoded->value == "+");
+        CHECK(std::get<int>(decoded->lhs) == 1);
+        REQUIRE(std::holds_alternative<std::shared_ptr<node>>(decoded->rhs));
+
+        const auto& rhs = *std::get<std::shared_ptr<node>>(decoded->rhs);
+        CHECK(rhs.value == "*");
+        CHECK(std::get<int>(rhs.lhs) == 2);
+        CHECK(std::get<std::string>(rhs.rhs) == "x");
+
+        CHECK_FALSE(fil::copa::snapshot::deserialize<node>(snapshot.substr(0, snapshot.size() - 1)).has_value());
+    }
+
+#if __cpp_structured_bindings >= 202411L
+    SECTION("aggregate snapshot") {
+        struct aggregate {
+            int id;
+            std::string name;
+            std::vector<double> values;
+        };
+
+        const auto decoded = fil::copa::snapshot::deserialize<aggregate>(fil::copa::snapshot::serialize(aggregate {1, "one", {1.5, 2.5}}));
+        REQUIRE(decoded.has_value());
+        CHECK(decoded->id == 1);
+        CHECK(decoded->name == "one");
+        CHECK(decoded->values == std::vector {1.5, 2.5});
+    }
+#endif
+
+    std::filesystem::remove_all(cache_directory);
+}
+
+TEST_CASE("Copa: parse with recovery", "[copa][recovery]") {
+    struct item_ast {
+        std::string name;
+        std::string type;
+    };
+
+    struct item_grammar {
+        using ast_object = item_ast;
+
+        static constexpr auto rules() {
+            return fil::copa::match_identifier<fil::copa::member<&ast_object::name>> {} //
+                 + fil::copa::double_point                                              //
+                 + fil::copa::match_identifier<fil::copa::member<&ast_object::type>> {} //
+                 + fil::copa::semicol;
+        }
+        static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+    };
+
+    struct items_ast {
+        std::vector<item_ast> items;
+    };
+
+    struct semicol_sync_grammar {
+        using ast_object = items_ast;
+
+        static constexpr auto rules() {
+            return fil::copa::list_rule<fil::copa::match_parser<item_grammar, fil::copa::member<&ast_object::items>>> {};
+        }
+        static constexpr auto sync() { return fil::copa::semicol; }
+        static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+    };
+
+    struct newline_sync_grammar {
+        using ast_object = items_ast;
+
+        static constexpr auto rules() {
+            return fil::copa::list_rule<fil::copa::match_parser<item_grammar, fil::copa::member<&ast_object::items>>> {};
+        }
+        static constexpr auto sync() { return fil::copa::match_char<'\n'> {}; }
+        static constexpr auto convertor() { return fil::copa::sink::aggregator<ast_object> {}; }
+    };
+
+    static_assert(fil::copa::recoverable_production<semicol_sync_grammar>);
+    static_assert(!fil::copa::recoverable_production<item_grammar>);
+
+    SECTION("no error") {
+        semicol_sync_grammar grammar;
+        const auto result = fil::copa::parse_with_recovery(grammar, fil::buffer_reader {"a : int ; b:string;"});
+        CHECK_FALSE(result.has_errors());
+        REQUIRE(result.ast.items.size() == 2);
+        CHECK(result.ast.items[0].name == "a");
+        CHECK(result.ast.items[1].name == "b");
+    }
+
+    SECTION("skip to the next semicolon") {
+        semicol_sync_grammar grammar;
+        const auto result = fil::copa::parse_with_recovery(grammar, fil::buffer_reader {"a:int; b int; c:vector; ; d : ; e:float;"});
+        CHECK(result.has_errors());
+        CHECK(result.errors.size() == 3);
+        REQUIRE(result.ast.items.size() == 3);
+        CHECK(result.ast.items[0].name == "a");
+        CHECK(result.ast.items[1].name == "c");
+        CHECK(result.ast.items[1].type == "vector");
+        CHECK(result.ast.items[2].name == "e");
+        CHECK(result.ast.items[2].type == "float");
+    }
+
+    SECTION("error at the end of the input") {
+        semicol_sync_grammar grammar;
+        const auto result = fil::copa::parse_with_recovery(grammar, fil::buffer_reader {"a:int; b : "});
+        CHECK(result.has_errors());
+        REQUIRE(result.ast.items.size() == 1);
+        CHECK(result.ast.items[0].name == "a");
+    }
+
+    SECTION("skip to the next line") {
+        newline_sync_grammar grammar;
+        const auto result = fil::copa::parse_with_recovery(grammar, fil::buffer_reader {"a:int;\nb int; c:map;\nd:string;\n"});
+        CHECK(result.errors.size() == 1);
+        REQUIRE(result.ast.items.size() == 2);
+        CHECK(result.ast.items[0].name == "a");
+        CHECK(result.ast.items[1].name == "d");
+    }
+}
+
 } // namespace
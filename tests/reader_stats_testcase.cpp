@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <string>
+
+#include "fil/file/file_reader.hh"
+#include "fil/meta/buffer_reader.hh"
+
+namespace {
+
+void write_file(const std::filesystem::path& file_path, const std::string& content) {
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(fmt::format("Could not open file for writing: {}", file_path.c_str()));
+    }
+    file << content;
+}
+
+} // namespace
+
+TEST_CASE("reader_stats_testcase", "[reader]") {
+    static_assert(fil::READER_STATS_ENABLED, "the test is compiled with FIL_READER_STATS");
+
+    std::string content;
+    for (std::size_t i = 1; content.size() < 100 * 1024; ++i) {
+        content += fmt::format("line number {}\n", i);
+    }
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_reader_stats.txt";
+    write_file(tmp_file, content);
+
+    SECTION("sequential read") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096});
+        CHECK(reader.stats().loads == 0);
+        while (reader.next_line().is_valid()) {}
+
+        const auto stats = reader.stats();
+        CHECK(stats.bytes_read == content.size());
+        CHECK(stats.loads == reader.load_counter());
+        CHECK(stats.backward_seeks == 0);
+        CHECK(stats.bytes_reread == 0);
+        CHECK(stats.shallow_copies == 0);
+        CHECK(stats.io_wait.count() > 0);
+    }
+
+    SECTION("backward reads and restore") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096});
+        std::ignore           = reader.next_line();
+        const auto checkpoint = reader.checkpoint();
+        std::ignore           = reader.next_line();
+        reader.restore(checkpoint); // same block: backtrack in the buffer
+        CHECK(reader.stats().backward_seeks == 1);
+        CHECK(reader.stats().bytes_reread == std::string_view("line number 2\n").size());
+        CHECK(reader.stats().bytes_read == 4096);
+
+        std::ignore = reader.tail(1); // the end of the file, then a backward read
+        CHECK(reader.previous_line().is_valid());
+        CHECK(reader.stats().backward_seeks == 1);
+        while (reader.previous_line().is_valid()) {}
+        CHECK(reader.stats().backward_seeks > 1);
+        CHECK(reader.stats().bytes_reread > 0);
+    }
+
+    SECTION("aggregated over the shallow copies") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096});
+        std::ignore = reader.next_line();
+        {
+            auto copy = fil::shallow_copy<fil::file_reader>::copy(reader);
+            for (std::size_t i = 0; i < 1000; ++i) {
+                std::ignore = copy.next_line();
+            }
+            CHECK(reader.stats().loads == copy.stats().loads);
+        }
+        const auto stats = reader.stats();
+        CHECK(stats.shallow_copies == 1);
+        CHECK(stats.loads > 1);
+        CHECK(stats.bytes_read > 4096);
+    }
+
+    SECTION("buffer_reader") {
+        fil::buffer_reader reader(std::string("kweh kweh"));
+        std::ignore      = reader.next_byte();
+        const auto saved = reader.checkpoint();
+        std::ignore      = reader.next_byte();
+        std::ignore      = reader.next_byte();
+
+        auto copy = fil::shallow_copy<fil::buffer_reader>::copy(reader);
+        copy.restore(saved);
+
+        const auto stats = reader.stats();
+        CHECK(stats.shallow_copies == 1);
+        CHECK(stats.backward_seeks == 1);
+        CHECK(stats.bytes_reread == 2);
+        CHECK(stats.bytes_read == 0);
+    }
+}
@@ -1,10 +1,23 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <filesystem>
 #include <fmt/format.h>
 #include <print>
 #include <ranges>
+#include <stop_token>
+#include <thread>
+#include <vector>
 
+#include "fil/file/delimited_reader.hh"
+#include "fil/file/file_follower.hh"
 #include "fil/file/file_reader.hh"
+#include "fil/file/file_writer.hh"
+#include "fil/file/mapped_file_reader.hh"
+#include "fil/file/parallel_lines.hh"
+#include "fil/file/sharded_reader.hh"
+#include "fil/file/temporary.hh"
 #include "fil/meta/buffer_reader.hh"
 
 namespace {
@@ -20,6 +33,11 @@ void write_file(const std::filesystem::path& file_path, const std::string& conte
     }
 }
 
+void append_file(const std::filesystem::path& file_path, const std::string& content) {
+    std::ofstream file(file_path, std::ios::app);
+    file << content;
+}
+
 } // namespace
 
 TEST_CASE("buffer reader", "[reader]") {
@@ -57,6 +75,19 @@ TEST_CASE("buffer reader", "[reader]") {
             CHECK(!reader.next_byte().has_value());
         }
     }
+    SECTION("string buffer :: checkpoint") {
+        fil::buffer_reader reader("abcdef");
+        CHECK(reader.next_byte() == 'a');
+
+        const auto checkpoint = reader.checkpoint();
+        CHECK(reader.next_byte() == 'b');
+        CHECK(reader.next_byte() == 'c');
+
+        reader.restore(checkpoint);
+        CHECK(reader.reader_cursor() == 1);
+        CHECK(reader.next_byte() == 'b');
+    }
+
     SECTION("read line-per-line") {
         fil::buffer_reader r(R"(_____begin
 Golden feathers catch the light,
@@ -104,6 +135,34 @@ You'll ride together, you and him.
             }
         }
 
+        SECTION("next lines in batch") {
+            std::array<std::string_view, 10> lines {};
+
+            CHECK(r.count_lines() == 26);
+            CHECK(r.next_lines(lines) == 10);
+            CHECK(lines[0] == "_____begin");
+            CHECK(lines[9] == "This yellow bird outruns them all.");
+            CHECK(r.next_lines(lines) == 10);
+            CHECK(r.next_lines(lines) == 6);
+            CHECK(lines[5] == "----end");
+            CHECK(r.next_lines(lines) == 0);
+        }
+
+        SECTION("read random lines with a line index") {
+            r.enable_line_index(4);
+
+            CHECK(r.read_line(22).get() == R"(So feed it greens and treat it well,)");
+            CHECK(r.read_line(12).get() == R"("Kweh!" it cries with joy and glee,)");
+            CHECK(r.read_line(1).get() == R"(_____begin)");
+            CHECK(r.read_line(26).get() == R"(----end)");
+            CHECK(r.read_line(42).get().empty());
+            CHECK(r.read_line(0).get().empty());
+
+            auto shallow = fil::shallow_copy<fil::buffer_reader>::copy(r);
+            CHECK(shallow.read_line(17).get() == R"(From sandy shores to snowy peak,)");
+            CHECK(shallow.next_line().get() == R"(For those who seek the mystique,)");
+        }
+
         SECTION("next line from start to end") {
             CHECK(r.next_line().get() == "_____begin");
             CHECK(r.next_line().get() == "Golden feathers catch the light,");
@@ -147,6 +206,58 @@ You'll ride together, you and him.
     }
 }
 
+TEST_CASE("buffer view reader", "[reader]") {
+    static_assert(std::is_trivially_copyable_v<fil::buffer_view_reader>);
+    static_assert([] {
+        fil::buffer_view_reader reader(std::string_view {"kweh"});
+        std::ignore = reader.next_byte();
+        return reader.next_byte() == 'w' && reader.peek() == 'e';
+    }());
+
+    const std::string content = "first line\nsecond line\n\nlast line";
+    fil::buffer_view_reader reader(content);
+
+    SECTION("bytes") {
+        CHECK(reader.previous_byte() == std::nullopt);
+        CHECK(reader.next_byte() == 'f');
+        CHECK(reader.peek() == 'i');
+        CHECK(reader.previous_byte() == 'f');
+        CHECK(reader.view().data() == content.data()); // no copy
+
+        const std::vector<char> bytes {'k', 'w', 'e', 'h'};
+        fil::buffer_view_reader from_bytes(bytes.data(), bytes.size());
+        CHECK(from_bytes.next_line().get() == "kweh");
+
+        fil::buffer_view_reader empty(std::string_view {});
+        CHECK(empty.next_byte() == std::nullopt);
+        CHECK(empty.peek() == std::nullopt);
+    }
+
+    SECTION("lines") {
+        CHECK(reader.next_line().get() == "first line");
+        CHECK(reader.next_line().get() == "second line");
+        CHECK(reader.next_line().get().empty());
+        CHECK(reader.next_line().get() == "last line");
+        CHECK(reader.next_line().get().empty());
+
+        CHECK(reader.read_line(2).get() == "second line");
+        CHECK(reader.read_line(4).get() == "last line");
+        CHECK(reader.read_line(5).get().empty());
+        CHECK(reader.read_line(0).get().empty());
+        CHECK(reader.count_lines() == 4);
+    }
+
+    SECTION("copies and checkpoints are independent cursors on the same memory") {
+        std::ignore      = reader.next_line();
+        const auto saved = reader.checkpoint();
+        auto copy        = fil::shallow_copy<fil::buffer_view_reader>::copy(reader);
+        CHECK(copy.next_line().get() == "second line");
+        CHECK(reader.next_line().get() == "second line");
+        reader.restore(saved);
+        CHECK(reader.next_line().get().data() == content.data() + 11);
+    }
+}
+
 TEST_CASE("read_file_testcase", "[reader]") {
     const auto tmp_file       = std::filesystem::temp_directory_path() / "test_file.txt";
     const std::string content = "This is a test file.\nIt has multiple lines.\nAnd some more text.";
@@ -206,6 +317,44 @@ TEST_CASE("read_file_testcase", "[reader]") {
         }
     }
 
+    SECTION("read_file :: shallow copy shares the file descriptor") {
+        CHECK(file_reader.next_byte() == 'T');
+
+        std::filesystem::remove(tmp_file); // the file isn't opened again by the copy: it is still readable
+        auto reader2 = fil::shallow_copy<fil::file_reader>::copy(file_reader);
+        CHECK(reader2.next_byte() == 'h');
+        CHECK(reader2.read_line(2).get() == "It has multiple lines.");
+        CHECK(file_reader.next_byte() == 'h');
+    }
+
+    SECTION("read_file :: checkpoint") {
+        CHECK(file_reader.next_byte() == 'T');
+        CHECK(file_reader.next_byte() == 'h');
+        CHECK(file_reader.next_byte() == 'i');
+        CHECK(file_reader.next_byte() == 's');
+
+        const auto checkpoint = file_reader.checkpoint();
+
+        SECTION("restore in the same block") {
+            CHECK(file_reader.next_line().get() == " is a test file.");
+            file_reader.restore(checkpoint);
+
+            CHECK(file_reader.load_counter() == 1); // no reload required
+            CHECK(file_reader.next_byte() == ' ');
+            CHECK(file_reader.next_byte() == 'i');
+        }
+
+        SECTION("restore after a reload") {
+            CHECK(file_reader.read_line(3).get() == "And some more text.");
+            CHECK(file_reader.load_counter() == 2);
+            file_reader.restore(checkpoint);
+
+            CHECK(file_reader.load_counter() == 3); // block of the checkpoint re-loaded
+            CHECK(file_reader.next_line().get() == " is a test file.");
+            CHECK(file_reader.next_line().get() == "It has multiple lines.");
+        }
+    }
+
     SECTION("get_line : success") {
         const auto line = file_reader.next_line();
 
@@ -409,4 +558,1141 @@ TEST_CASE("read_file_testcase", "[reader]") {
             CHECK(lines[2] == "And some more text.");
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("read_file_testcase read ahead", "[reader]") {
+    std::string content;
+    for (std::size_t i = 0; content.size() < 3 * fil::READER_BUFFER_SIZE; ++i) {
+        content += fmt::format("line number {}\n", i);
+    }
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_read_ahead.txt";
+    write_file(tmp_file, content);
+
+    fil::file_reader reader(tmp_file, fil::read_ahead_mode {.in_flight = 2});
+    CHECK(reader.is_read_ahead());
+
+    SECTION("read ahead :: sequential read") {
+        std::string read;
+        read.reserve(content.size());
+        while (const auto c = reader.next_byte()) {
+            read += static_cast<char>(c.value());
+        }
+        CHECK(read == content);
+        CHECK(reader.load_counter() >= 4);
+    }
+
+    SECTION("read ahead :: non sequential read") {
+        CHECK(reader.read_line(100000).get() == "line number 99999");
+        const auto checkpoint = reader.checkpoint();
+        CHECK(reader.next_line().get() == "line number 100000");
+
+        CHECK(reader.read_line(10).get() == "line number 9");
+        reader.restore(checkpoint);
+        CHECK(reader.next_line().get() == "line number 100000");
+    }
+}
+
+TEST_CASE("read_file_testcase carry over", "[reader]") {
+    std::string content;
+    for (std::size_t i = 1; content.size() < 3 * fil::READER_BUFFER_SIZE; ++i) {
+        content += fmt::format("line number {}\n", i);
+    }
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_carry_over.txt";
+    write_file(tmp_file, content);
+
+    fil::file_reader reader(tmp_file);
+
+    SECTION("next_line : lines overlapping two blocks are not cut") {
+        std::size_t expected = 1;
+        bool all_match       = true;
+        while (true) {
+            const auto line = reader.next_line();
+            if (!line.is_valid()) {
+                break;
+            }
+            all_match &= (line.get() == fmt::format("line number {}", expected++));
+        }
+        CHECK(all_match);
+        CHECK(expected - 1 == static_cast<std::size_t>(std::ranges::count(content, '\n')));
+    }
+
+    SECTION("read_until : tokens overlapping two blocks, the file is never read backward") {
+        std::string read;
+        std::streamoff file_cursor = 0;
+        bool never_backward        = true;
+        while (true) {
+            const auto token = reader.read_until([](char c) { return c == ' ' || c == '\n'; });
+            if (!token.is_valid()) {
+                break;
+            }
+            read += token.get();
+            if (const auto cursor = static_cast<std::streamoff>(reader.get_file_cursor()); cursor >= 0) {
+                never_backward &= cursor >= file_cursor;
+                file_cursor = cursor;
+            }
+        }
+        CHECK(read == content);
+        CHECK(never_backward);
+    }
+
+    SECTION("next_line : lines ending at the end of the buffer") {
+        const auto read_lines = [&tmp_file](const std::string& text) {
+            write_file(tmp_file, text);
+            fil::file_reader small_blocks(tmp_file, {.block_size = 4});
+            std::vector<std::string> lines;
+            for (auto line = small_blocks.next_line(); line.is_valid(); line = small_blocks.next_line()) {
+                lines.emplace_back(line.get());
+            }
+            return lines;
+        };
+        using lines = std::vector<std::string>;
+
+        // line of exactly block_size: its end of line is in the next block
+        CHECK(read_lines("abcd\nx\n") == lines {"abcd", "x"});
+        // line of block_size + carry over: the end of line follows the buffer
+        CHECK(read_lines("ab\ncdefg\nx\n") == lines {"ab", "cdefg", "x"});
+        // line filling the whole buffer (headroom + block)
+        CHECK(read_lines("abcdefgh\nx\n") == lines {"abcdefgh", "x"});
+        // line bigger than the buffer: it is split
+        CHECK(read_lines("abcdefghijk\nx\n") == lines {"abcdefgh", "ijk", "x"});
+
+        write_file(tmp_file, "ab\ncdefg\nx\n");
+        fil::file_reader small_blocks(tmp_file, {.block_size = 4});
+        CHECK(small_blocks.next_line().get() == "ab");
+        CHECK(small_blocks.next_line().get() == "cdefg");
+        CHECK(small_blocks.previous_byte() == static_cast<std::uint8_t>('\n'));
+        CHECK(small_blocks.next_byte() == static_cast<std::uint8_t>('\n'));
+        CHECK(small_blocks.next_line().get() == "x");
+    }
+}
+
+TEST_CASE("read_file_testcase buffer pool", "[reader]") {
+    std::string content;
+    for (std::size_t i = 1; content.size() < 200 * 1024; ++i) {
+        content += fmt::format("line number {}\n", i);
+    }
+    const auto tmp_file   = std::filesystem::temp_directory_path() / "test_file_buffer_pool.txt";
+    const auto small_file = std::filesystem::temp_directory_path() / "test_file_buffer_pool_small.txt";
+    write_file(tmp_file, content);
+    write_file(small_file, "first\nsecond\n");
+
+    const auto read_all = [](fil::file_reader& reader) {
+        std::string read;
+        for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+            read += line.get();
+            read += '\n';
+        }
+        return read;
+    };
+
+    auto pool = fil::buffer_pool::create();
+
+    SECTION("the buffer is borrowed at the first read and given back on destruction") {
+        {
+            fil::file_reader reader(tmp_file, {.pool = pool});
+            CHECK(pool->in_use() == 0);
+            CHECK(reader.buffer_capacity() == 0);
+            CHECK(reader.next_line().get() == "line number 1");
+            CHECK(pool->in_use() == 1);
+            CHECK(reader.buffer_capacity() >= reader.block_size());
+        }
+        CHECK(pool->in_use() == 0);
+        CHECK(pool->cached_bytes() > 0);
+
+        const auto cached = pool->cached_bytes();
+        fil::file_reader reader(tmp_file, {.pool = pool});
+        CHECK(reader.next_line().get() == "line number 1");
+        CHECK(pool->cached_bytes() == cached - reader.buffer_capacity()); // the buffer is re-used
+    }
+
+    SECTION("a small file is read in a buffer of its size") {
+        fil::file_reader reader(small_file, {.pool = pool});
+        CHECK(reader.block_size() == 14);
+        CHECK(read_all(reader) == "first\nsecond\n");
+        CHECK(reader.buffer_capacity() == fil::BUFFER_POOL_ALIGNMENT);
+    }
+
+    SECTION("custom block size") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096, .pool = pool});
+        CHECK(reader.block_size() == 4096);
+        CHECK(read_all(reader) == content);
+        CHECK(reader.load_counter() > content.size() / 4096);
+
+        fil::file_reader tiny(tmp_file, {.block_size = 64, .pool = pool}); // block size bigger than a line
+        CHECK(read_all(tiny) == content);
+
+        fil::file_reader read_ahead(tmp_file, {.block_size = 4096, .pool = pool, .read_ahead = fil::read_ahead_mode {.in_flight = 2}});
+        CHECK(read_all(read_ahead) == content);
+    }
+
+    SECTION("release_buffer : the read continues from the cursor") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096, .pool = pool});
+        std::string read;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            read += reader.read_until([](char c) { return c == ' ' || c == '\n'; }).get();
+            if (i % 10 == 0) {
+                reader.release_buffer();
+                CHECK(pool->in_use() == 0);
+            }
+        }
+        read += read_all(reader);
+        CHECK(read == content);
+    }
+
+    SECTION("many readers share the pool") {
+        std::vector<fil::file_reader> readers;
+        for (std::size_t i = 0; i < 32; ++i) {
+            readers.emplace_back(tmp_file, fil::reader_options {.block_size = 16 * 1024, .pool = pool});
+        }
+        bool all_match = true;
+        for (std::size_t round = 0; round < 3; ++round) {
+            for (auto& reader : readers) {
+                all_match &= reader.next_line().is_valid();
+                reader.release_buffer();
+            }
+        }
+        CHECK(all_match);
+        CHECK(pool->in_use() == 0);
+        // a single buffer (headroom, block and null-terminator) re-used by all the readers in turn
+        CHECK(pool->cached_bytes() == 2 * 16 * 1024 + fil::BUFFER_POOL_ALIGNMENT);
+    }
+}
+
+TEST_CASE("read_file_testcase reverse lines", "[reader]") {
+    std::vector<std::string> expected;
+    std::string content;
+    for (std::size_t i = 1; content.size() < 300 * 1024; ++i) {
+        expected.push_back(fmt::format("line number {}{}", i, std::string(i % 50, '.')));
+        content += expected.back() + '\n';
+    }
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_reverse_lines.txt";
+    write_file(tmp_file, content);
+
+    SECTION("iterate from the last line to the first one") {
+        for (const std::size_t block_size : {std::size_t {4096}, std::size_t {100}, fil::READER_BUFFER_SIZE}) {
+            fil::file_reader reader(tmp_file, {.block_size = block_size});
+            std::vector<std::string> read;
+            for (const auto& line : fil::file_reader_reverse_line(reader)) {
+                read.emplace_back(line.get());
+            }
+            std::ranges::reverse(read);
+            CHECK(read == expected);
+        }
+    }
+
+    SECTION("tail") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096});
+        const auto last = reader.tail(3);
+        CHECK(last == std::vector<std::string>(expected.end() - 3, expected.end()));
+        CHECK(reader.load_counter() == 1); // only the end of the file is read
+
+        // the cursor is at the beginning of the lines retrieved
+        CHECK(reader.next_line().get() == last[0]);
+
+        CHECK(reader.tail(0).empty());
+        CHECK(reader.tail(expected.size() + 10) == expected);
+    }
+
+    SECTION("last line without end of line, empty lines") {
+        write_file(tmp_file, "first\n\nthird\nlast");
+        fil::file_reader reader(tmp_file);
+        CHECK(reader.tail(10) == std::vector<std::string> {"first", "", "third", "last"});
+    }
+
+    SECTION("previous_line from the middle of the file, next_line afterward") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096});
+        for (std::size_t i = 0; i < 1000; ++i) {
+            std::ignore = reader.next_line();
+        }
+        CHECK(reader.previous_line().get() == expected[999]);
+        CHECK(reader.previous_line().get() == expected[998]);
+        CHECK(reader.next_line().get() == expected[998]);
+        CHECK(reader.next_line().get() == expected[999]);
+        CHECK(reader.next_line().get() == expected[1000]);
+    }
+
+    SECTION("previous_byte across blocks") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096});
+        std::size_t read = 0;
+        while (read < 10000 && reader.next_byte().has_value()) {
+            ++read;
+        }
+        std::string backward;
+        while (const auto c = reader.previous_byte()) {
+            backward.push_back(static_cast<char>(*c));
+        }
+        std::ranges::reverse(backward);
+        CHECK(backward == content.substr(0, 10000));
+        CHECK(reader.next_byte() == static_cast<std::uint8_t>(content[0]));
+    }
+
+    SECTION("next_line after a backward load to the beginning of the file") {
+        write_file(tmp_file, "dl\nabcdefg\nhij\nklm\n");
+        fil::file_reader reader(tmp_file, {.block_size = 8});
+        std::ignore           = reader.next_byte();
+        const auto checkpoint = reader.checkpoint();
+        CHECK(reader.next_line().get() == "l");
+        CHECK(reader.next_line().get() == "abcdefg");
+        CHECK(reader.next_line().get() == "hij");
+        reader.restore(checkpoint);
+        CHECK(reader.previous_byte() == static_cast<std::uint8_t>('d'));
+        // the block loaded backward ends before the end of the file: the line continues in the next block
+        CHECK(reader.next_line().get() == "dl");
+        CHECK(reader.next_line().get() == "abcdefg");
+    }
+}
+
+TEST_CASE("read_file_testcase direct io", "[reader]") {
+    std::vector<std::string> expected;
+    std::string content;
+    for (std::size_t i = 1; content.size() < 300 * 1024; ++i) {
+        expected.push_back(fmt::format("line number {}{}", i, std::string(i % 50, '.')));
+        content += expected.back() + '\n';
+    }
+    content += "last line without end of line";
+    expected.emplace_back("last line without end of line");
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_direct_io.txt";
+    write_file(tmp_file, content);
+
+    SECTION("file_handle :: unaligned direct reads") {
+        const fil::file_handle file(tmp_file, fil::cache_mode::direct);
+        REQUIRE(file.is_open());
+        std::string buffer(10'000, '\0');
+        for (const std::size_t offset : {std::size_t {0}, std::size_t {1}, std::size_t {4095}, std::size_t {4096}, content.size() - 100}) {
+            const auto read = file.read_at(buffer.data(), buffer.size(), offset);
+            REQUIRE(read.has_value());
+            CHECK(std::string_view(buffer.data(), *read) == std::string_view(content).substr(offset, buffer.size()));
+        }
+        CHECK(file.read_at(buffer.data(), buffer.size(), content.size()) == std::optional<std::size_t> {0});
+    }
+
+    SECTION("sequential read") {
+        for (const std::size_t block_size : {std::size_t {4096}, std::size_t {10'000}, fil::READER_BUFFER_SIZE}) {
+            for (const auto cache : {fil::cache_mode::direct, fil::cache_mode::drop}) {
+                fil::file_reader reader(tmp_file, {.block_size = block_size, .cache = cache});
+                CHECK(reader.cache() != fil::cache_mode::keep);
+                if (reader.cache() == fil::cache_mode::direct) {
+                    CHECK(reader.block_size() % fil::DIRECT_IO_ALIGNMENT == 0);
+                }
+                std::vector<std::string> read;
+                for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+                    read.emplace_back(line.get());
+                }
+                CHECK(read == expected);
+            }
+        }
+    }
+
+    SECTION("read ahead") {
+        fil::file_reader reader(tmp_file, {.block_size = 8192, .read_ahead = fil::read_ahead_mode {}, .cache = fil::cache_mode::direct});
+        std::vector<std::string> read;
+        for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+            read.emplace_back(line.get());
+        }
+        CHECK(read == expected);
+    }
+
+    SECTION("unaligned loads") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096, .cache = fil::cache_mode::direct});
+        CHECK(reader.read_line(1000).get() == expected[999]);
+        CHECK(reader.next_line().get() == expected[1000]);
+        const auto checkpoint = reader.checkpoint();
+        for (std::size_t i = 1001; i < 2000; ++i) {
+            CHECK(reader.next_line().get() == expected[i]);
+        }
+        reader.restore(checkpoint);
+        CHECK(reader.next_line().get() == expected[1001]);
+
+        // tokens overlapping the end of the block: leftovers carried over, or read again from unaligned positions
+        auto position = content.find('\n' + expected[1002] + '\n') + 1;
+        for (const std::size_t size : {std::size_t {100}, std::size_t {4000}, std::size_t {3000}, std::size_t {4096}}) {
+            const auto token = reader.read_until([size](std::string_view token) { return token.size() == size; }, size);
+            CHECK(token.get() == std::string_view(content).substr(position, size));
+            position += size;
+        }
+        CHECK(reader.count_lines() == expected.size());
+    }
+
+    SECTION("reverse lines") {
+        fil::file_reader reader(tmp_file, {.block_size = 4096, .cache = fil::cache_mode::direct});
+        CHECK(reader.tail(3) == std::vector<std::string>(expected.end() - 3, expected.end()));
+        std::vector<std::string> read;
+        for (const auto& line : fil::file_reader_reverse_line(reader)) {
+            read.emplace_back(line.get());
+        }
+        std::ranges::reverse(read);
+        CHECK(read == expected);
+    }
+}
+
+TEST_CASE("read_file_testcase next_lines", "[reader]") {
+    std::string content;
+    for (std::size_t i = 1; i <= 200000; ++i) {
+        content += fmt::format("line number {}\n", i);
+    }
+    content += "last line";
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_next_lines.txt";
+    write_file(tmp_file, content);
+
+    fil::file_reader reader(tmp_file);
+    CHECK(reader.count_lines() == 200001);
+
+    // lines overlapping two blocks are not cut
+    std::array<std::string_view, 100> lines {};
+    std::size_t expected = 1;
+    bool all_match       = true;
+    while (const auto filled = reader.next_lines(lines)) {
+        for (const auto line : std::span(lines).first(filled)) {
+            all_match &= (line == (expected <= 200000 ? fmt::format("line number {}", expected) : "last line"));
+            ++expected;
+        }
+    }
+    CHECK(all_match);
+    CHECK(expected == 200002);
+    CHECK(reader.load_counter() > 1);
+
+    SECTION("next_lines :: span bigger than the lines of a block") {
+        std::string small_content;
+        for (std::size_t i = 1; i <= 2000; ++i) {
+            small_content += fmt::format("{} {}\n", i, std::string(i % 150, 'x')); // some lines are bigger than a block
+        }
+        small_content += "last line";
+        const auto small_file = std::filesystem::temp_directory_path() / "test_file_next_lines_small.txt";
+        write_file(small_file, small_content);
+
+        std::vector<std::string> by_line;
+        fil::file_reader line_reader(small_file, {.block_size = 64});
+        for (auto line = line_reader.next_line(); line.is_valid(); line = line_reader.next_line()) {
+            by_line.emplace_back(line.get());
+        }
+
+        std::vector<std::string> by_batch;
+        fil::file_reader batch_reader(small_file, {.block_size = 64});
+        while (const auto filled = batch_reader.next_lines(lines)) {
+            by_batch.insert(by_batch.end(), lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(filled));
+        }
+        CHECK(by_batch.size() == by_line.size());
+        CHECK(by_batch == by_line);
+        CHECK(batch_reader.load_counter() > 1);
+    }
+}
+
+TEST_CASE("read_file_testcase line index", "[reader]") {
+    std::string content;
+    for (std::size_t i = 1; i <= 5000; ++i) {
+        content += fmt::format("line number {}\n", i);
+    }
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_line_index.txt";
+    write_file(tmp_file, content);
+
+    SECTION("line index :: read_line") {
+        fil::file_reader reader(tmp_file);
+        reader.enable_line_index(64);
+
+        CHECK(reader.read_line(4000).get() == "line number 4000");
+        CHECK(reader.next_line().get() == "line number 4001");
+        CHECK(reader.read_line(1).get() == "line number 1");
+        CHECK(reader.read_line(64).get() == "line number 64");
+        CHECK(reader.read_line(65).get() == "line number 65");
+        CHECK(reader.read_line(5000).get() == "line number 5000");
+        CHECK(!reader.read_line(5001).is_valid());
+        CHECK(!reader.read_line(0).is_valid());
+
+        auto shallow = fil::shallow_copy<fil::file_reader>::copy(reader);
+        CHECK(shallow.read_line(2500).get() == "line number 2500");
+    }
+
+    SECTION("line index :: persisted sidecar") {
+        fil::file_reader reader(tmp_file);
+        reader.enable_line_index(64, true);
+        std::filesystem::remove(reader.line_index_path());
+
+        CHECK(reader.read_line(1234).get() == "line number 1234");
+        REQUIRE(std::filesystem::exists(reader.line_index_path()));
+
+        const auto loaded = fil::line_index::load(reader.line_index_path(), std::filesystem::file_size(tmp_file),
+                                                  std::filesystem::last_write_time(tmp_file).time_since_epoch().count());
+        REQUIRE(loaded.has_value());
+        CHECK(loaded->line_count() == 5000);
+        CHECK(loaded->stride() == 64);
+
+        SECTION("outdated sidecar is not loaded") {
+            write_file(tmp_file, "first line\nsecond line\n");
+            CHECK(!fil::line_index::load(reader.line_index_path(), std::filesystem::file_size(tmp_file),
+                                         std::filesystem::last_write_time(tmp_file).time_since_epoch().count())
+                       .has_value());
+
+            fil::file_reader updated(tmp_file);
+            updated.enable_line_index(64, true);
+            CHECK(updated.read_line(2).get() == "second line");
+            CHECK(!updated.read_line(3).is_valid());
+        }
+
+        SECTION("corrupted sidecar is not loaded") {
+            const auto load = [&] {
+                return fil::line_index::load(reader.line_index_path(), std::filesystem::file_size(tmp_file),
+                                             std::filesystem::last_write_time(tmp_file).time_since_epoch().count());
+            };
+            SECTION("huge number of offsets") {
+                std::fstream sidecar(reader.line_index_path(), std::ios::binary | std::ios::in | std::ios::out);
+                const std::uint64_t offsets = std::uint64_t {1} << 60;
+                sidecar.seekp(40); // magic, version, size, modification time, stride and line count precede it
+                sidecar.write(reinterpret_cast<const char*>(&offsets), sizeof(offsets));
+            }
+            SECTION("truncated offsets") {
+                std::filesystem::resize_file(reader.line_index_path(), std::filesystem::file_size(reader.line_index_path()) - 8);
+            }
+            CHECK_NOTHROW(load());
+            CHECK(!load().has_value());
+
+            fil::file_reader rebuilt(tmp_file);
+            rebuilt.enable_line_index(64, true);
+            CHECK(rebuilt.read_line(4321).get() == "line number 4321");
+        }
+        std::filesystem::remove(reader.line_index_path());
+    }
+}
+
+TEST_CASE("parallel_lines_testcase", "[reader]") {
+    std::string content;
+    std::size_t expected_sum = 0;
+    for (std::size_t i = 1; i <= 100000; ++i) {
+        content += fmt::format("{}\n", i);
+        expected_sum += i;
+    }
+    content += "42";
+    expected_sum += 42;
+    const auto tmp_file = std::filesystem::temp_directory_path() / "test_file_parallel_lines.txt";
+    write_file(tmp_file, content);
+
+    SECTION("split_on_lines") {
+        CHECK(fil::split_on_lines("", 2) == std::vector<std::size_t> {0});
+        CHECK(fil::split_on_lines("aa\nbb\ncc", 2) == std::vector<std::size_t> {0, 3, 6, 8});
+        CHECK(fil::split_on_lines("aaaaa\nb", 2) == std::vector<std::size_t> {0, 6, 7});
+        CHECK(fil::split_on_lines("aa\nbb", 100) == std::vector<std::size_t> {0, 5});
+    }
+
+    SECTION("parallel_for_each_line") {
+        std::atomic<std::size_t> lines {0};
+        std::atomic<std::size_t> sum {0};
+        fil::parallel_for_each_line(
+            tmp_file,
+            [&](std::string_view line) {
+                ++lines;
+                sum += std::stoul(std::string(line));
+            },
+            fil::thread_executor {.workers = 4}, 4096);
+        CHECK(lines == 100001);
+        CHECK(sum == expected_sum);
+    }
+
+    SECTION("parallel_for_each_chunk : results in order") {
+        const auto first_lines = fil::parallel_for_each_chunk(
+            tmp_file,
+            [](const fil::file_chunk& chunk) {
+                return std::stoul(std::string(chunk.content.substr(0, chunk.content.find('\n'))));
+            },
+            fil::thread_executor {}, 10000);
+        REQUIRE(first_lines.size() > 1);
+        CHECK(first_lines.front() == 1);
+        CHECK(std::ranges::is_sorted(first_lines));
+    }
+
+    SECTION("parallel_reduce_lines") {
+        const auto sum = fil::parallel_reduce_lines(
+            tmp_file, std::size_t {0}, [](std::size_t& acc, std::string_view line) { acc += std::stoul(std::string(line)); },
+            std::plus<> {}, fil::thread_executor {}, 1000);
+        CHECK(sum == expected_sum);
+    }
+
+    SECTION("errors") {
+        CHECK_THROWS_AS(fil::parallel_for_each_line(std::filesystem::temp_directory_path() / "non_existing_parallel.txt",
+                                                    [](std::string_view) {}),
+                        std::runtime_error);
+        CHECK_THROWS_AS(fil::parallel_for_each_line(
+                            tmp_file,
+                            [](std::string_view line) {
+                                if (line == "1000") {
+                                    throw std::logic_error("kweh");
+                                }
+                            },
+                            fil::thread_executor {}, 100),
+                        std::logic_error);
+    }
+}
+
+TEST_CASE("sharded_reader_testcase", "[reader]") {
+    const auto directory = std::filesystem::temp_directory_path() / "test_sharded_reader";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> expected;
+    for (std::size_t shard = 0; shard < 12; ++shard) {
+        std::string content;
+        for (std::size_t line = 0; line < shard * 100; ++line) { // the first shard is empty
+            expected.push_back(fmt::format("shard {} line {}", shard, line));
+            content += expected.back() + '\n';
+        }
+        write_file(directory / fmt::format("part-{:02}.txt", shard), content);
+    }
+    write_file(directory / "README.md", "not a shard\n");
+
+    const auto paths = fil::glob_shards(directory / "part-*.txt");
+    REQUIRE(paths.size() == 12);
+    CHECK(paths.front().filename() == "part-00.txt");
+    CHECK(paths.back().filename() == "part-11.txt");
+
+    SECTION("glob") {
+        CHECK(fil::glob_shards(directory / "part-0?.txt").size() == 10);
+        CHECK(fil::glob_shards(directory / "*").size() == 13);
+        CHECK(fil::glob_shards(directory / "*.md").size() == 1);
+        CHECK(fil::glob_shards(directory / "part-*-*.txt").empty());
+        CHECK(fil::glob_shards(directory / "missing" / "*").empty());
+    }
+
+    SECTION("single stream of lines") {
+        fil::sharded_reader reader(paths, {.prefetch = 3});
+        CHECK(reader.shard_count() == 12);
+        std::vector<std::string> read;
+        for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+            read.emplace_back(line.get());
+        }
+        CHECK(read == expected);
+
+        std::size_t total_size = 0;
+        for (const auto& path : paths) {
+            total_size += std::filesystem::file_size(path);
+        }
+        CHECK(reader.reader_cursor() == total_size);
+    }
+
+    SECTION("read_line : the lines are counted from the beginning of the stream") {
+        fil::sharded_reader reader(paths, {.reader = {.block_size = 4096}});
+        CHECK(reader.read_line(150).get() == expected[149]);
+        CHECK(reader.next_line().get() == expected[150]);
+        CHECK(reader.read_line(1000).get() == expected[999]);
+        CHECK(!reader.read_line(10).is_valid()); // already read
+        CHECK(!reader.read_line(expected.size() + 1).is_valid());
+    }
+
+    SECTION("bytes") {
+        fil::sharded_reader reader({paths[1], directory / "missing.txt", paths[2]});
+        std::string read;
+        CHECK(reader.peek() == 's');
+        while (const auto c = reader.next_byte()) {
+            read.push_back(static_cast<char>(*c));
+        }
+        std::string concatenated;
+        for (std::size_t i = 0; i < 300; ++i) {
+            concatenated += expected[i] + '\n';
+        }
+        CHECK(read == concatenated);
+        CHECK(reader.peek() == std::nullopt);
+    }
+
+    SECTION("biggest shards first") {
+        fil::sharded_reader reader(paths, {.order_by_size = true});
+        std::vector<std::string> order;
+        while (const auto shard = reader.next_shard()) {
+            order.push_back(shard->get_path().filename().string());
+        }
+        REQUIRE(order.size() == 12);
+        CHECK(order.front() == "part-11.txt");
+        CHECK(order.back() == "part-00.txt");
+    }
+
+    SECTION("parallel consumers") {
+        fil::sharded_reader reader(paths);
+        std::atomic<std::size_t> lines {0};
+        std::atomic<std::size_t> shards {0};
+        {
+            std::vector<std::jthread> consumers;
+            for (std::size_t i = 0; i < 4; ++i) {
+                consumers.emplace_back([&] {
+                    while (auto shard = reader.next_shard()) {
+                        ++shards;
+                        for (auto line = shard->next_line(); line.is_valid(); line = shard->next_line()) {
+                            ++lines;
+                        }
+                    }
+                });
+            }
+        }
+        CHECK(shards == 12);
+        CHECK(lines == expected.size());
+    }
+
+    SECTION("destroyed before reading every shard") {
+        fil::sharded_reader reader(paths, {.prefetch = 1});
+        CHECK(reader.next_line().get() == expected[0]);
+    }
+}
+
+TEST_CASE("mapped_file_reader_testcase", "[reader]") {
+    const auto tmp_file       = std::filesystem::temp_directory_path() / "test_mapped_file.txt";
+    const std::string content = "This is a test file.\nIt has multiple lines.\nAnd some more text.";
+    write_file(tmp_file, content);
+
+    fil::mapped_file_reader reader(tmp_file);
+
+    REQUIRE(reader.is_open());
+    CHECK(reader.exists());
+    CHECK(reader.size() == content.size());
+    CHECK(reader.view() == content);
+
+    SECTION("mapped_file :: shallow copy") {
+        CHECK(reader.next_byte() == 'T');
+        CHECK(reader.next_byte() == 'h');
+
+        fil::mapped_file_reader reader2 = fil::shallow_copy<fil::mapped_file_reader>::copy(reader);
+        CHECK(reader2.is_shallow_copy());
+        CHECK(reader2.next_byte() == 'i');
+        CHECK(reader2.next_byte() == 's');
+
+        CHECK(reader.next_byte() == 'i');
+
+        fil::shallow_copy<fil::mapped_file_reader>::assign(reader, std::move(reader2));
+        CHECK(reader.next_byte() == ' ');
+    }
+
+    SECTION("mapped_file :: checkpoint") {
+        CHECK(reader.next_line().get() == "This is a test file.");
+        const auto checkpoint = reader.checkpoint();
+
+        CHECK(reader.read_line(3).get() == "And some more text.");
+        reader.restore(checkpoint);
+        CHECK(reader.next_line().get() == "It has multiple lines.");
+    }
+
+    SECTION("mapped_file :: lines") {
+        const auto line1 = reader.next_line();
+        const auto line2 = reader.next_line();
+        const auto line3 = reader.next_line();
+        CHECK(!reader.next_line().is_valid());
+
+        // blocks stay valid for the lifetime of the reader
+        CHECK(line1.get() == "This is a test file.");
+        CHECK(line2.get() == "It has multiple lines.");
+        CHECK(line3.get() == "And some more text.");
+
+        CHECK(reader.read_line(2).get() == "It has multiple lines.");
+        CHECK(!reader.read_line(0).is_valid());
+        CHECK(!reader.read_line(4).is_valid());
+    }
+
+    SECTION("mapped_file :: read_until") {
+        CHECK(reader.read_until([](char c) { return c == ' '; }).get() == "This ");
+        CHECK(reader.read_until([](std::string_view sv) { return sv.ends_with("test"); }).get() == "is a test");
+        CHECK(!reader.read_until([](char c) { return c == '#'; }).is_valid());
+        CHECK(reader.next_byte() == ' ');
+    }
+
+    SECTION("mapped_file :: advise") {
+        CHECK(reader.advise(fil::access_advice::will_need));
+        CHECK(reader.advise(fil::access_advice::random, 10, 5));
+        CHECK(!fil::shallow_copy<fil::mapped_file_reader>::copy(reader).advise(fil::access_advice::sequential));
+    }
+
+    SECTION("mapped_file :: non-existing file") {
+        fil::mapped_file_reader non_existing(std::filesystem::temp_directory_path() / "non_existing_mapped_file.txt");
+        CHECK(!non_existing.is_open());
+        CHECK(!non_existing.next_byte().has_value());
+        CHECK(!non_existing.next_line().is_valid());
+    }
+}
+
+TEST_CASE("file_follower_testcase", "[reader]") {
+    using namespace std::chrono_literals;
+
+    const auto tmp = std::filesystem::temp_directory_path() / "fil_file_follower_test";
+    std::filesystem::remove_all(tmp);
+    std::filesystem::create_directories(tmp);
+    const auto log = tmp / "app.log";
+    write_file(log, "old line\n");
+
+    SECTION("follow :: starts at the end of the file") {
+        fil::file_follower follower(log, {.poll_interval = 10ms});
+        REQUIRE(follower.is_open());
+        CHECK(!follower.try_next_line().is_valid());
+
+        append_file(log, "first\nsecond\nthi");
+        CHECK(follower.try_next_line().get() == "first");
+        CHECK(follower.try_next_line().get() == "second");
+        CHECK(!follower.try_next_line().is_valid()); // incomplete line
+
+        append_file(log, "rd\n");
+        CHECK(follower.try_next_line().get() == "third");
+        CHECK(follower.file_position() == std::filesystem::file_size(log));
+    }
+
+    SECTION("follow :: from the beginning") {
+        fil::file_follower follower(log, {.from_beginning = true, .poll_interval = 10ms});
+        CHECK(follower.try_next_line().get() == "old line");
+        CHECK(!follower.next_line(30ms).is_valid());
+    }
+
+    SECTION("follow :: the backlog is read chunk by chunk") {
+        std::string backlog;
+        for (std::size_t i = 1; backlog.size() < 20 * fil::FOLLOWER_READ_SIZE; ++i) {
+            backlog += fmt::format("backlog line {}\n", i);
+        }
+        const std::string long_line(3 * fil::FOLLOWER_READ_SIZE, 'x');
+        write_file(log, backlog + long_line + "\nlast\n");
+
+        fil::file_follower follower(log, {.from_beginning = true, .poll_interval = 10ms});
+        CHECK(follower.try_next_line().get() == "backlog line 1");
+        CHECK(follower.file_position() == fil::FOLLOWER_READ_SIZE); // only the first chunk is read
+
+        std::size_t lines = 1;
+        auto line         = follower.try_next_line();
+        for (; line.is_valid() && line.get() != long_line; line = follower.try_next_line()) {
+            ++lines;
+        }
+        CHECK(lines == static_cast<std::size_t>(std::ranges::count(backlog, '\n')));
+        CHECK(line.get() == long_line);
+        CHECK(follower.try_next_line().get() == "last");
+        CHECK(!follower.try_next_line().is_valid());
+        CHECK(follower.file_position() == std::filesystem::file_size(log));
+    }
+
+    SECTION("follow :: blocking next_line") {
+        fil::file_follower follower(log, {.poll_interval = 10ms});
+        std::jthread writer([&] {
+            std::this_thread::sleep_for(50ms);
+            append_file(log, "appended later\n");
+        });
+        CHECK(follower.next_line(5s).get() == "appended later");
+    }
+
+    SECTION("follow :: callback until stop") {
+        fil::file_follower follower(log, {.poll_interval = 10ms});
+        append_file(log, "a\nb\nc\n");
+
+        std::stop_source stop;
+        std::vector<std::string> lines;
+        follower.follow(stop.get_token(), [&](std::string_view line) {
+            lines.emplace_back(line);
+            if (lines.size() == 3) {
+                stop.request_stop();
+            }
+        });
+        CHECK(lines == std::vector<std::string> {"a", "b", "c"});
+    }
+
+    SECTION("follow :: truncation") {
+        fil::file_follower follower(log, {.from_beginning = true, .poll_interval = 10ms});
+        CHECK(follower.try_next_line().get() == "old line");
+
+        write_file(log, "new\n");
+        CHECK(follower.try_next_line().get() == "new");
+        CHECK(follower.rotation_count() == 1);
+    }
+
+    SECTION("follow :: rotation by rename") {
+        fil::file_follower follower(log, {.poll_interval = 10ms});
+        append_file(log, "before rotation\nunterminated");
+        std::filesystem::rename(log, tmp / "app.log.1");
+        append_file(tmp / "app.log.1", " end of old file\n");
+        write_file(log, "in the new file\n");
+
+        CHECK(follower.try_next_line().get() == "before rotation");
+        CHECK(follower.try_next_line().get() == "unterminated end of old file");
+        CHECK(follower.try_next_line().get() == "in the new file");
+        CHECK(follower.rotation_count() == 1);
+    }
+
+    SECTION("follow :: file created after the follower") {
+        fil::file_follower follower(tmp / "later.log", {.poll_interval = 10ms});
+        CHECK(!follower.is_open());
+        CHECK(!follower.try_next_line().is_valid());
+
+        write_file(tmp / "later.log", "created\n");
+        CHECK(follower.try_next_line().get() == "created");
+        CHECK(follower.is_open());
+        CHECK(follower.rotation_count() == 0);
+    }
+
+    std::filesystem::remove_all(tmp);
+}
+
+TEST_CASE("file_writer_testcase", "[reader]") {
+    using namespace std::chrono_literals;
+
+    const auto tmp = std::filesystem::temp_directory_path() / "fil_file_writer_test";
+    std::filesystem::remove_all(tmp);
+    std::filesystem::create_directories(tmp);
+    const auto out = tmp / "out.txt";
+
+    const auto read_all = [](const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+
+    SECTION("writer :: small appends are buffered") {
+        fil::file_writer writer(out, {.buffer_size = 4096});
+        REQUIRE(writer.is_open());
+        writer.write("abc");
+        writer.write_line("def");
+        CHECK(std::filesystem::file_size(out) == 0);
+        CHECK(writer.bytes_written() == 7);
+
+        CHECK(writer.flush());
+        CHECK(read_all(out) == "abcdef\n");
+    }
+
+    SECTION("writer :: appends bigger than the buffer") {
+        std::string expected;
+        {
+            fil::file_writer writer(out, {.buffer_size = 4096});
+            for (std::size_t i = 0; i < 100; ++i) {
+                const auto line = std::string(i * 97, static_cast<char>('a' + i % 26));
+                writer.write_line(line);
+                expected += line + "\n";
+            }
+        }
+        CHECK(read_all(out) == expected);
+    }
+
+    SECTION("writer :: vectored append") {
+        const std::string big(10'000, 'x');
+        const std::array<std::string_view, 4> pieces {"head ", big, " - ", "tail"};
+        {
+            fil::file_writer writer(out, {.buffer_size = 4096});
+            writer.write("start ");
+            writer.write(pieces);
+            CHECK(writer.close());
+            CHECK(!writer.is_open());
+        }
+        CHECK(read_all(out) == "start head " + big + " - tail");
+    }
+
+    SECTION("writer :: append to an existing file") {
+        write_file(out, "existing\n");
+        {
+            fil::file_writer writer(out, {.append = true});
+            writer.write_line("appended");
+        }
+        CHECK(read_all(out) == "existing\nappended\n");
+    }
+
+    SECTION("writer :: sync policies") {
+        for (const auto policy : {fil::sync_policy::every_n_bytes, fil::sync_policy::group_commit}) {
+            {
+                fil::file_writer writer(out, {.buffer_size = 4096, .sync = policy, .sync_bytes = 8192, .sync_interval = 1ms});
+                for (int i = 0; i < 1000; ++i) {
+                    writer.write_line("synced line");
+                }
+                CHECK(writer.sync());
+                CHECK(!writer.error());
+            }
+            CHECK(std::filesystem::file_size(out) == 1000 * std::string_view("synced line\n").size());
+        }
+    }
+
+    SECTION("writer :: background flush") {
+        fil::file_writer writer(out, {.sync = fil::sync_policy::group_commit, .background_flush = true, .sync_interval = 5ms});
+        writer.write_line("flushed in background");
+
+        for (int i = 0; i < 400 && std::filesystem::file_size(out) == 0; ++i) {
+            std::this_thread::sleep_for(5ms);
+        }
+        CHECK(read_all(out) == "flushed in background\n");
+        CHECK(writer.bytes_written() == std::string_view("flushed in background\n").size());
+    }
+
+    SECTION("writer :: close doesn't wait for the background sync interval") {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 20; ++i) {
+            fil::file_writer writer(out, {.background_flush = true, .sync_interval = 10s});
+            writer.write_line("closed right away");
+            CHECK(writer.close());
+        }
+        CHECK(std::chrono::steady_clock::now() - start < 10s);
+        CHECK(read_all(out) == "closed right away\n");
+    }
+
+    SECTION("writer :: direct io") {
+        std::string expected;
+        {
+            fil::file_writer writer(out, {.buffer_size = 8192, .direct_io = true});
+            REQUIRE(writer.is_open());
+            for (int i = 0; i < 3000; ++i) {
+                const auto line = fmt::format("direct line {}", i);
+                writer.write_line(line);
+                expected += line + "\n";
+            }
+        }
+        // O_DIRECT is silently disabled where the filesystem doesn't support it, the content is the same anyway
+        CHECK(read_all(out) == expected);
+    }
+
+    SECTION("writer :: copy and transform lines from a file_reader") {
+        write_file(tmp / "in.txt", "keep 1\ndrop 2\nkeep 3\n");
+        fil::file_reader reader(tmp / "in.txt");
+        {
+            fil::file_writer writer(out);
+            const auto lines = fil::transform_lines(reader, writer, [](std::string_view line, fil::file_writer& w) {
+                if (line.starts_with("keep")) {
+                    w.write_line(line.substr(5));
+                }
+            });
+            CHECK(lines == 3);
+        }
+        CHECK(read_all(out) == "1\n3\n");
+
+        fil::file_reader copy_reader(tmp / "in.txt");
+        {
+            fil::file_writer writer(tmp / "copy.txt");
+            CHECK(fil::copy_lines(copy_reader, writer) == 3);
+        }
+        CHECK(read_all(tmp / "copy.txt") == "keep 1\ndrop 2\nkeep 3\n");
+    }
+
+    SECTION("writer :: error on open") {
+        fil::file_writer writer(tmp / "missing_directory" / "out.txt");
+        CHECK(!writer.is_open());
+        CHECK(writer.error());
+        writer.write("ignored");
+        CHECK(!writer.flush());
+    }
+
+    std::filesystem::remove_all(tmp);
+}
+
+TEST_CASE("delimited_reader_testcase", "[reader]") {
+    const auto tmp = std::filesystem::temp_directory_path() / "fil_delimited_reader_test";
+    std::filesystem::remove_all(tmp);
+    std::filesystem::create_directories(tmp);
+
+    std::string content = "id,name,comment\r\n";
+    for (std::size_t i = 0; i < 20'000; ++i) {
+        // every 3rd comment is quoted and contains a delimiter, an escaped quote and an end of line
+        content += fmt::format("{},name {},{}\r\n", i, i, i % 3 == 0 ? "\"a, \"\"b\"\"\nc\"" : "plain");
+    }
+    write_file(tmp / "data.csv", content);
+
+    SECTION("delimited_reader :: sequential") {
+        fil::delimited_reader reader(tmp / "data.csv");
+        REQUIRE(reader.is_open());
+
+        const auto header = reader.next_record();
+        REQUIRE(header.is_valid());
+        CHECK(std::vector<std::string_view>(header.begin(), header.end()) == std::vector<std::string_view> {"id", "name", "comment"});
+
+        std::size_t records = 0;
+        for (auto record = reader.next_record(); record.is_valid(); record = reader.next_record()) {
+            REQUIRE(record.size() == 3);
+            CHECK(record[0] == std::to_string(records));
+            CHECK(record[2] == (records % 3 == 0 ? "a, \"\"b\"\"\nc" : "plain"));
+            ++records;
+        }
+        CHECK(records == 20'000);
+        CHECK(reader.reader_cursor() == content.size());
+    }
+
+    SECTION("delimited_reader :: split_on_records skips quoted ends of line") {
+        const auto bounds = fil::split_on_records(content, {}, fil::thread_executor {.workers = 4}, 1000);
+        REQUIRE(bounds.size() > 2);
+        for (std::size_t i = 1; i + 1 < bounds.size(); ++i) {
+            CHECK(content.substr(bounds[i] - 2, 2) == "\r\n");
+            CHECK(content[bounds[i]] != 'c'); // not inside a quoted comment
+        }
+    }
+
+    SECTION("delimited_reader :: parallel") {
+        const auto [records, quoted] = fil::parallel_reduce_records(
+            tmp / "data.csv", std::pair<std::size_t, std::size_t> {0, 0},
+            [](auto& acc, const fil::delimited_record& record) {
+                ++acc.first;
+                acc.second += record[2].contains('\n') ? 1 : 0;
+            },
+            [](auto lhs, auto rhs) { return std::pair {lhs.first + rhs.first, lhs.second + rhs.second}; }, {},
+            fil::thread_executor {.workers = 4}, 4096);
+        CHECK(records == 20'001);
+        CHECK(quoted == 6'667);
+
+        std::atomic<std::size_t> total {0};
+        fil::parallel_for_each_record(
+            tmp / "data.csv", [&](const fil::delimited_record& record) { total += record.size(); }, {}, fil::thread_executor {}, 4096);
+        CHECK(total == 3 * 20'001);
+    }
+
+    std::filesystem::remove_all(tmp);
+}
+
+TEST_CASE("memory_file_testcase", "[reader]") {
+
+    SECTION("memory_file :: read by the readers") {
+        fil::memory_file file("first\nsecond\n");
+        file.append("third\n");
+        CHECK(file.size() == 19);
+        if (file.is_memfd()) {
+            CHECK(file.path().string().starts_with("/proc/self/fd/"));
+        }
+
+        fil::file_reader reader(file.path());
+        CHECK(reader.next_line().get() == "first");
+        CHECK(reader.next_line().get() == "second");
+        CHECK(reader.next_line().get() == "third");
+        CHECK_FALSE(reader.next_line().is_valid());
+
+        fil::mapped_file_reader mapped(file);
+        CHECK(mapped.read_line(3).get() == "third");
+    }
+
+    SECTION("memory_file :: generated lines") {
+        fil::memory_file file;
+        file.append_lines(100'000, 15, 'k');
+        CHECK(file.size() == 100'000 * 16);
+
+        fil::file_reader reader(file.path(), {.block_size = 64 * 1024});
+        std::size_t lines = 0;
+        for (auto line = reader.next_line(); line.is_valid(); line = reader.next_line()) {
+            CHECK(line.get() == "kkkkkkkkkkkkkkk");
+            ++lines;
+        }
+        CHECK(lines == 100'000);
+
+        fil::memory_file numbered;
+        numbered.append_lines(50'000, [](std::size_t index) { return fmt::format("line {}", index); });
+        fil::file_reader numbered_reader(numbered.path());
+        CHECK(numbered_reader.read_line(1).get() == "line 0");
+        CHECK(numbered_reader.read_line(50'000).get() == "line 49999");
+        CHECK_FALSE(numbered_reader.next_line().is_valid());
+    }
+
+    SECTION("memory_file :: sparse resize") {
+        fil::memory_file file("head\n");
+        file.resize(1024 * 1024 * 1024);
+        file.append("\ntail\n");
+        CHECK(file.size() == 1024 * 1024 * 1024 + 6);
+        CHECK(std::filesystem::file_size(file.path()) == file.size());
+
+        fil::file_reader reader(file.path());
+        CHECK(reader.next_line().get() == "head");
+        CHECK(reader.tail(1) == std::vector<std::string> {"tail"});
+    }
+
+    SECTION("memory_file :: released upon destruction") {
+        std::filesystem::path path;
+        {
+            fil::memory_file file("kweh");
+            fil::memory_file moved(std::move(file));
+            CHECK(moved.size() == 4);
+            path = moved.path();
+            CHECK(std::filesystem::exists(path));
+        }
+        CHECK_FALSE(std::filesystem::exists(path));
+    }
+
+    SECTION("temporary_file :: unique names") {
+        std::vector<fil::temporary_file> files;
+        files.reserve(100); // not copied: a copy would remove the file once destroyed
+        std::vector<std::filesystem::path> paths;
+        for (std::size_t i = 0; i < 100; ++i) {
+            paths.push_back(files.emplace_back("content", "fil_unique"));
+        }
+        std::ranges::sort(paths);
+        CHECK(std::ranges::adjacent_find(paths) == paths.end());
+    }
+}
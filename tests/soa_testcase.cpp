@@ -14,7 +14,15 @@
 // Created by fys on 05.10.24.
 //
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <fil/datastructure/soa.hh>
 
 TEST_CASE("soa_vector", "[datastructure]") {
@@ -201,7 +209,25 @@ TEST_CASE("soa_vector", "[datastructure]") {
         }
 
         SECTION("using_old_id_after_erase") {
-            //@todo : implement a at function
+            CHECK_FALSE(s.at(id3).has_value());
+
+            const auto id3_bis = s.insert(50, 50.50, "fifty");
+            CHECK_FALSE(s.has_id(id3)); // same slot, previous generation
+            CHECK_FALSE(s.at(id3).has_value());
+            REQUIRE(s.at(id3_bis).has_value());
+            CHECK(get<2>(*s.at(id3_bis)) == "fifty");
+            CHECK(get<2>(*s.at(id4)) == "four");
+
+            const auto& const_s = s;
+            CHECK(get<0>(*const_s.at(id1)) == 1);
+            CHECK_FALSE(const_s.at(id3).has_value());
+        }
+
+        SECTION("id_never_inserted") {
+            using soa_type = fil::soa::soa<int, double, std::string>;
+            CHECK_FALSE(s.has_id(soa_type::struct_id {2, 1})); // free slot, generation not given yet
+            CHECK_FALSE(s.has_id(soa_type::struct_id {4, 0})); // slot never used
+            CHECK_FALSE(s.at(soa_type::struct_id {100, 0}).has_value());
         }
         SECTION("test_erase_all") {
             CHECK(s.erase(id1));
@@ -211,6 +237,36 @@ TEST_CASE("soa_vector", "[datastructure]") {
         }
     }
 
+    SECTION("erase_and_insert_stress") {
+        // ids stay valid through the moves of the data on erase, the erased ids are rejected
+        using id_type = fil::soa::soa<int, double, std::string>::struct_id;
+        std::vector<std::pair<id_type, int>> alive {{id1, 1}, {id2, 2}, {id3, 3}, {id4, 4}};
+        std::vector<id_type> erased;
+        for (int i = 5; i < 2000; ++i) {
+            if (i % 3 == 0) {
+                const auto victim = alive[static_cast<std::size_t>(i * 7) % alive.size()];
+                CHECK(s.erase(victim.first));
+                erased.push_back(victim.first);
+                std::erase(alive, victim);
+            } else {
+                alive.emplace_back(s.insert(i, i * 1.0, std::to_string(i)), i);
+            }
+        }
+        CHECK(s.size() == alive.size());
+        for (const auto& [id, value] : alive) {
+            REQUIRE(s.has_id(id));
+            CHECK(get<0>(s[id]) == value);
+            CHECK(get<0>(*s.at(id)) == value);
+            CHECK(s[id].struct_id() == id);
+        }
+        for (const auto& id : erased) {
+            if (std::ranges::find(alive, id, &std::pair<id_type, int>::first) == alive.end()) {
+                CHECK_FALSE(s.has_id(id));
+                CHECK_FALSE(s.erase(id));
+            }
+        }
+    }
+
     SECTION("modifications") {
 
         const auto it = std::ranges::find_if( //
@@ -233,4 +289,79 @@ TEST_CASE("soa_vector", "[datastructure]") {
         CHECK(int_v_bis == 1337);
         CHECK(str_v_bis == "two");
     }
-}
\ No newline at end of file
+}
+TEST_CASE("soa_columns", "[datastructure]") {
+
+    fil::soa::soa<int, double, std::string> s {};
+    const auto id1 = s.insert(1, 1.1, "one");
+    const auto id2 = s.insert(2, 2.2, "two");
+    const auto id3 = s.insert(3, 3.3, "three");
+
+    SECTION("column_access") {
+        const auto ints = s.column<0>();
+        REQUIRE(ints.size() == 3);
+        CHECK(ints[0] == 1);
+        CHECK(ints[2] == 3);
+        CHECK(s.column<std::string>()[1] == "two");
+        CHECK(s.column<double>().data() == s.column<1>().data());
+
+        s.column<int>()[1] = 42;
+        CHECK(get<0>(s[id2]) == 42);
+
+        const auto& const_s = s;
+        CHECK(const_s.column<std::string>()[0] == "one");
+
+        // the last structure is moved in place of the erased one: the columns stay contiguous
+        CHECK(s.erase(id1));
+        REQUIRE(s.column<0>().size() == 2);
+        CHECK(s.column<0>()[0] == 3);
+        CHECK(s.column<2>()[0] == "three");
+        CHECK(get<0>(s[id3]) == 3);
+    }
+
+    SECTION("for_each_columns") {
+        // a generic kernel is given the elements, never the spans
+        double sum = 0.0;
+        std::as_const(s).for_each_columns<1>([&sum](const auto& d) { sum += d; });
+        CHECK(sum == 1.1 + 2.2 + 3.3);
+
+        s.for_each_columns<0, 1>([](int& i, double& d) { d += i; });
+        CHECK(get<1>(s[id1]) == 2.1);
+        CHECK(get<1>(s[id3]) == 6.3);
+
+        std::size_t length = 0;
+        std::as_const(s).for_each_columns<2>([&length](const std::string& str) { length += str.size(); });
+        CHECK(length == 11);
+    }
+
+    SECTION("with_columns") {
+        s.with_columns<0, 1>([](std::span<int> ints, std::span<double> doubles) {
+            for (std::size_t i = 0; i < ints.size(); ++i) {
+                doubles[i] = ints[i] * 10.0;
+            }
+        });
+        CHECK(get<1>(s[id2]) == 20.0);
+
+        const auto count = std::as_const(s).with_columns<2>([](std::span<const std::string> strings) { return strings.size(); });
+        CHECK(count == 3);
+
+        const auto total = s.with_columns<0>([](auto ints) { return std::accumulate(ints.begin(), ints.end(), 0); });
+        CHECK(total == 6);
+    }
+
+    SECTION("aligned_columns") {
+        fil::soa::aligned_soa<64, float, float, char> particles {};
+        for (int i = 0; i < 1000; ++i) {
+            std::ignore = particles.insert(static_cast<float>(i), 1.0f, 'p');
+        }
+        const auto is_aligned = [](const void* data) { return reinterpret_cast<std::uintptr_t>(data) % 64 == 0; };
+        CHECK(is_aligned(particles.column<0>().data()));
+        CHECK(is_aligned(particles.column<1>().data()));
+        CHECK(is_aligned(particles.column<2>().data()));
+
+        particles.for_each_columns<0, 1>([](float& position, const float& velocity) { position += velocity * 0.5f; });
+        CHECK(particles.column<0>()[0] == 0.5f);
+        CHECK(particles.column<0>()[999] == 999.5f);
+        CHECK(particles.column<char>()[500] == 'p');
+    }
+}